@@ -0,0 +1,260 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Run a whole blocking job on the process wide thread pool and
+collect its result later, so the caller can do other work meanwhile.
+
+runAsync() queues the job on getThreadPool() and returns an
+AsyncResult.  The job's own parallel work is launched from the worker
+running it and shared with the pool as usual.  wait() and get() run
+the job themselves if no worker has taken it yet, as ThreadPool::wait()
+does, but never pick up other queued jobs, so waiting on one result is
+not held up by another caller's long job.  With no
+pool workers (one thread) the job runs at once, inside runAsync().
+
+The job runs under its own ParallelControl built from the token and
+callback given to runAsync(), not under the caller's, which may be gone
+by the time the job starts.
+
+Anything the job reads or writes through pointers must stay valid until
+the result is ready.  Destroying an AsyncResult waits for its job.  The
+thread policy in simple-thread-dispatch.hpp may not be changed while a
+job is outstanding.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <parallel-control.hpp>
+#include <thread-pool.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//STRUCT DEFINITIONS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename T> struct asyncState{
+  ThreadPool *pool;
+  threadPoolGroup group;
+  std::function<T()> job;
+  CancellationToken *token;
+  parallelProgressCallback progress;
+  void *context;
+
+  T result;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Handle to the result of a job started by runAsync().  Move only.
+ **********************************************************************/
+template<typename T> class AsyncResult{
+  private:
+  std::unique_ptr<asyncState<T> > state;
+
+  public:
+
+/***********************************************************************
+ * A handle with no job, for which valid() is false.
+ **********************************************************************/
+  AsyncResult();
+
+
+/***********************************************************************
+ * Take ownership of a queued or finished job.  Used by runAsync().
+ **********************************************************************/
+  explicit AsyncResult(std::unique_ptr<asyncState<T> > state);
+
+
+  AsyncResult(AsyncResult &&other);
+  AsyncResult& operator=(AsyncResult &&other);
+  AsyncResult(const AsyncResult&) = delete;
+  AsyncResult& operator=(const AsyncResult&) = delete;
+
+
+/***********************************************************************
+ * Wait for the job, if any.
+ **********************************************************************/
+  ~AsyncResult();
+
+
+/***********************************************************************
+ * Whether the handle has a job whose result has not been taken.
+ **********************************************************************/
+  bool valid() const;
+
+
+/***********************************************************************
+ * Whether the job has finished, without waiting.
+ **********************************************************************/
+  bool isReady() const;
+
+
+/***********************************************************************
+ * Return once the job has finished, running pool jobs meanwhile.
+ **********************************************************************/
+  void wait();
+
+
+/*******************************************************************//**
+ * \brief Wait for the job and move its result out.  valid() is false
+ * afterwards.  Must only be called while valid().
+ **********************************************************************/
+  T get();
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DECLARATIONS////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Queue job() on the process wide pool.
+ *
+ * @param[in] job Callable returning T, a default constructible type.
+ *
+ * @param[in] token If not NULL, cancels the job; see parallel-control.hpp.
+ *
+ * @param[in] progress If not NULL, told of the job's progress.
+ *
+ * @param[in] context Passed to progress.
+ **********************************************************************/
+template<typename T, typename Job> AsyncResult<T> runAsync(Job job,
+                                CancellationToken *token = NULL,
+                                parallelProgressCallback progress = NULL,
+                                void *context = NULL);
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE TEMPLATE FUNCTION DEFINITIONS/////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename T> void *asyncHelper(void *protoArgs){
+  asyncState<T> *state = (asyncState<T>*) protoArgs;
+
+  ParallelControl control(state->token, state->progress, state->context);
+  state->result = state->job();
+
+  return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename T> AsyncResult<T>::AsyncResult(){}
+
+
+template<typename T> AsyncResult<T>::AsyncResult(
+                                std::unique_ptr<asyncState<T> > state){
+  this->state = std::move(state);
+}
+
+
+template<typename T> AsyncResult<T>::AsyncResult(AsyncResult &&other){
+  state = std::move(other.state);
+}
+
+
+template<typename T> AsyncResult<T>& AsyncResult<T>::operator=(
+                                                  AsyncResult &&other){
+  if(this != &other){
+    wait();
+    state = std::move(other.state);
+  }
+  return *this;
+}
+
+
+template<typename T> AsyncResult<T>::~AsyncResult(){
+  wait();
+}
+
+
+template<typename T> bool AsyncResult<T>::valid() const{
+  return NULL != state;
+}
+
+
+template<typename T> bool AsyncResult<T>::isReady() const{
+  return NULL != state && 0 == state->group.pending;
+}
+
+
+template<typename T> void AsyncResult<T>::wait(){
+  if(NULL != state) state->pool->wait(&state->group);
+}
+
+
+template<typename T> T AsyncResult<T>::get(){
+  wait();
+  T tr = std::move(state->result);
+  state.reset();
+  return tr;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DEFINITIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Job> AsyncResult<T> runAsync(Job job,
+                                CancellationToken *token,
+                                parallelProgressCallback progress,
+                                void *context){
+  std::unique_ptr<asyncState<T> > state(new asyncState<T>());
+  state->pool = &getThreadPool();
+  state->job = job;
+  state->token = token;
+  state->progress = progress;
+  state->context = context;
+
+  if(0 == state->pool->numberOfWorkers()){
+    asyncHelper<T>((void*) state.get());
+    return AsyncResult<T>(std::move(state));
+  }
+
+  //The caller's ParallelControl may be gone before the job starts, so
+  //the job must not inherit it.
+  ParallelControl *callerControl = swapParallelControl(NULL);
+  state->pool->submit(asyncHelper<T>, (void*) state.get(), &state->group);
+  swapParallelControl(callerControl);
+
+  return AsyncResult<T>(std::move(state));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,178 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief A file backed record of which tiles of a correlation triangle
+have been computed, and their values, so an interrupted job can resume.
+
+The upper triangle of an numRows x numRows matrix is cut into square
+tiles of tileSize x tileSize.  Tiles are numbered row by row along the
+upper triangle of tiles: tile 0 is (0, 0), then (1, 0) up to the end of
+the first tile row, then (1, 1), and so on.  Each tile has a fixed slot
+in the file, and a bitmap records which slots are complete.  A tile's
+values are flushed to disk before its bit is set, so a preempted job
+loses at most the tiles that were in flight.
+
+File layout:
+  header (4096 bytes, see checkpointHeader)
+  completion bitmap, padded to a multiple of 4096 bytes
+  numberOfTiles() tiles of tileSize * tileSize f64 values, row major
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+class CorrelationCheckpoint{
+  private:
+  int fd;
+  size_t numRows;
+  size_t numCols;
+  size_t tileSize;
+  u64 inputHash;
+  size_t tilesPerSide;
+  std::vector<std::pair<size_t, size_t> > tileXY;
+  std::vector<u8> bitmap;
+  size_t bitmapOffset;
+  size_t dataOffset;
+  std::mutex bitmapLock;
+
+  bool readHeaderAndBitmap();
+  bool writeHeaderAndBitmap();
+
+  public:
+
+/***********************************************************************
+ * Create a closed checkpoint.  Call open() before use.
+ **********************************************************************/
+  CorrelationCheckpoint();
+
+
+/***********************************************************************
+ * Close the file if still open.
+ **********************************************************************/
+  ~CorrelationCheckpoint();
+
+
+  CorrelationCheckpoint(const CorrelationCheckpoint&) = delete;
+  CorrelationCheckpoint& operator=(const CorrelationCheckpoint&) = delete;
+
+
+/*******************************************************************//**
+ * \brief Open or create a checkpoint file for a job.
+ *
+ * If resume is true and path holds a checkpoint for the same job (same
+ * dimensions, tile size and input hash), its completed tiles are kept.
+ * Otherwise the file is started afresh.
+ *
+ * @return false if the file could not be opened, read or created.
+ **********************************************************************/
+  bool open(const std::string &path, csize_t numRows, csize_t numCols,
+            csize_t tileSize, cu64 inputHash, const bool resume);
+
+
+/***********************************************************************
+ * Close the file.  Completed tiles stay on disk.
+ **********************************************************************/
+  void close();
+
+
+/***********************************************************************
+ * Number of tiles covering the upper triangle.
+ **********************************************************************/
+  size_t numberOfTiles() const;
+
+
+/***********************************************************************
+ * Side length of a tile, in rows.
+ **********************************************************************/
+  size_t getTileSize() const;
+
+
+/***********************************************************************
+ * Tile coordinates (tileX, tileY) of a tile number, with tileX >= tileY.
+ * Tile (tileX, tileY) covers columns [tileX*tileSize, ...) and rows
+ * [tileY*tileSize, ...), clipped to numRows.
+ **********************************************************************/
+  std::pair<size_t, size_t> tileCoordinates(csize_t tile) const;
+
+
+/***********************************************************************
+ * Number of tiles already on disk.
+ **********************************************************************/
+  size_t numberOfCompletedTiles();
+
+
+/***********************************************************************
+ * Whether a tile's values are already on disk.
+ **********************************************************************/
+  bool isTileComplete(csize_t tile);
+
+
+/*******************************************************************//**
+ * \brief Persist a tile and mark it complete.  Safe to call from many
+ * threads for different tiles.
+ *
+ * @param[in] values tileSize * tileSize values, row major, as laid out
+ * by the caller.
+ *
+ * @return false on I/O failure, in which case the tile is not marked.
+ **********************************************************************/
+  bool writeTile(csize_t tile, cf64 *values);
+
+
+/*******************************************************************//**
+ * \brief Read a completed tile.
+ *
+ * @param[out] values Receives tileSize * tileSize values.
+ **********************************************************************/
+  bool readTile(csize_t tile, f64 *values);
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief FNV-1a hash of expression data, used to tell whether a
+ * checkpoint belongs to the same input.
+ **********************************************************************/
+u64 hashExpressionData(const std::vector<std::vector<double> > &data);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -22,6 +22,10 @@
 /*******************************************************************//**
 @file
 @brief Define interfaces to generate various covariance matrixes.
+
+Each of these may be cancelled and its progress followed through a
+ParallelControl on the calling thread, see parallel-control.hpp.  A
+cancelled call returns an empty matrix or triangle.
 ***********************************************************************/
 
 #pragma once
@@ -30,8 +34,12 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <string>
 #include <vector>
+#include <async-result.hpp>
+#include <parallel-control.hpp>
 #include <short-primatives.h>
+#include <upper-diagonal-square-matrix.hpp>
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -60,14 +68,50 @@ calculateKendallsTauCorrelationCorrelationMatrix(
   const std::vector<size_t> *againstRows = nullptr);
 
 
+/*******************************************************************//**
+ * \brief As calculateKendallsTauCorrelationCorrelationMatrix(), but
+ * queued on the thread pool with runAsync(); see async-result.hpp.
+ * expressionData and againstRows must stay valid until the result is
+ * ready.
+ *
+ * @param[in] token If not NULL, cancels the job.
+ *
+ * @param[in] progress If not NULL, told of the job's progress.
+ *
+ * @param[in] context Passed to progress.
+ **********************************************************************/
+extern AsyncResult<std::vector<std::vector<double> > >
+calculateKendallsTauCorrelationCorrelationMatrixAsync(
+  std::vector<std::vector<double> > *expressionData,
+  const std::vector<size_t> *againstRows = nullptr,
+  CancellationToken *token = NULL,
+  parallelProgressCallback progress = NULL,
+  void *context = NULL);
+
+
+/*******************************************************************//**
+ * \brief As calculateKendallsTauCorrelationCorrelationMatrix() for
+ * every row, but return the triangle itself rather than copying it into
+ * a dense matrix, which would take twice the memory.
+ *
+ * @param[in,out] expressionData expressionData[numRows][numCols].  Rows
+ * are ranked in place.
+ *
+ * @return The numRows x numRows triangle, 1 on the diagonal.
+ **********************************************************************/
+extern UpperDiagonalSquareMatrix<f64>
+calculateKendallsTauCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData);
+
+
 /*******************************************************************//**
  * \brief From expression data, construct a upper-diagonal section of a
  * correlation matrix, omitting the x=y entries using the Pearson
  * Correlation Coefficient.
  *
- * @param[in] expressionData A number of rows monitoring a variable over
+ * @param[in,out] expressionData A number of rows monitoring a variable over
  * a number of columns reporting samples for that variable.
- * expressionData[numRows][numCols].
+ * expressionData[numRows][numCols].  Rows are centered in place.
  *
  * @param[in] againstRows An optional argument to limit calculation to a
  * set of rows.  Default = nullptr.
@@ -82,6 +126,101 @@ calculatePearsonCorrelationMatrix(
   const std::vector<size_t> *againstRows = nullptr);
 
 
+/*******************************************************************//**
+ * \brief As calculatePearsonCorrelationMatrix(), but queued on the
+ * thread pool with runAsync(); see async-result.hpp.  expressionData
+ * and againstRows must stay valid until the result is ready.
+ *
+ * @param[in] token If not NULL, cancels the job.
+ *
+ * @param[in] progress If not NULL, told of the job's progress.
+ *
+ * @param[in] context Passed to progress.
+ **********************************************************************/
+extern AsyncResult<std::vector<std::vector<double> > >
+calculatePearsonCorrelationMatrixAsync(
+  std::vector<std::vector<double> > *expressionData,
+  const std::vector<size_t> *againstRows = nullptr,
+  CancellationToken *token = NULL,
+  parallelProgressCallback progress = NULL,
+  void *context = NULL);
+
+
+/*******************************************************************//**
+ * \brief As calculatePearsonCorrelationMatrix() for every row, but
+ * return the triangle itself rather than copying it into a dense
+ * matrix, which would take twice the memory.
+ *
+ * @param[in,out] expressionData expressionData[numRows][numCols].  Rows
+ * are centered in place.
+ *
+ * @return The numRows x numRows triangle, 1 on the diagonal.
+ **********************************************************************/
+extern UpperDiagonalSquareMatrix<f64>
+calculatePearsonCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData);
+
+
+/*******************************************************************//**
+ * \brief As calculatePearsonCorrelationTriangle(), but run as a task
+ * graph rather than stage by stage.  Rows are prepared (ranked if asked,
+ * then centered) in blocks of blockSize, and each blockSize square tile
+ * of the triangle is computed as soon as its two row blocks are ready,
+ * so correlation starts before every row is prepared.
+ *
+ * @param[in,out] expressionData expressionData[numRows][numCols].  Rows
+ * are ranked if rankRows, then centered, in place.
+ *
+ * @param[in] rankRows Rank each row first, giving Spearman rather than
+ * Pearson correlation.
+ *
+ * @param[in] blockSize Rows per block.  Default = 256.
+ *
+ * @return The numRows x numRows triangle, 1 on the diagonal.
+ **********************************************************************/
+extern UpperDiagonalSquareMatrix<f64>
+calculatePipelinedCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData, const bool rankRows,
+  csize_t blockSize = 256);
+
+
+/*******************************************************************//**
+ * \brief As calculatePearsonCorrelationMatrix(), but the triangle is
+ * computed as numbered tiles which are saved to a checkpoint file as
+ * they finish.  If the job is interrupted, calling again with the same
+ * data and checkpoint file only computes the missing tiles.
+ *
+ * @param[in] expressionData A number of rows monitoring a variable over
+ * a number of columns reporting samples for that variable.
+ * expressionData[numRows][numCols].  Left unchanged, so that a retry
+ * with the same rows finds its tiles; a centered copy is worked on
+ * instead.
+ *
+ * @param[in] checkpointPath File holding completed tiles.  Created if
+ * missing.  It may be removed once the result has been consumed.
+ *
+ * @param[in] againstRows An optional argument to limit calculation to a
+ * set of rows.  Default = nullptr.
+ *
+ * @param[in] tileSize Side length of a tile in rows.  Preemption loses
+ * at most one tile per worker.  Default = 512.
+ *
+ * @param[in] resume Whether to reuse tiles from an existing checkpoint
+ * for the same input.  If false the checkpoint is restarted.
+ * Default = true.
+ *
+ * @return The requested rows of the correlation matrix, or an empty
+ * matrix if the checkpoint file could not be read or written.
+ **********************************************************************/
+extern std::vector<std::vector<double> >
+calculatePearsonCorrelationMatrixCheckpointed(
+  std::vector<std::vector<double> > *expressionData,
+  const std::string &checkpointPath,
+  const std::vector<size_t> *againstRows = nullptr,
+  csize_t tileSize = 512,
+  const bool resume = true);
+
+
 /*******************************************************************//**
  * \brief From expression data, construct a upper-diagonal section of a
  * correlation matrix, omitting the x=y entries using the Spearman
@@ -103,6 +242,41 @@ calculateSpearmanCorrelationMatrix(
   std::vector<std::vector<double> > *expressionData,
   const std::vector<size_t> *againstRows = nullptr);
 
+
+/*******************************************************************//**
+ * \brief As calculateSpearmanCorrelationMatrix(), but queued on the
+ * thread pool with runAsync(); see async-result.hpp.  expressionData
+ * and againstRows must stay valid until the result is ready.
+ *
+ * @param[in] token If not NULL, cancels the job.
+ *
+ * @param[in] progress If not NULL, told of the job's progress.
+ *
+ * @param[in] context Passed to progress.
+ **********************************************************************/
+extern AsyncResult<std::vector<std::vector<double> > >
+calculateSpearmanCorrelationMatrixAsync(
+  std::vector<std::vector<double> > *expressionData,
+  const std::vector<size_t> *againstRows = nullptr,
+  CancellationToken *token = NULL,
+  parallelProgressCallback progress = NULL,
+  void *context = NULL);
+
+
+/*******************************************************************//**
+ * \brief As calculateSpearmanCorrelationMatrix() for every row, but
+ * return the triangle itself rather than copying it into a dense
+ * matrix, which would take twice the memory.
+ *
+ * @param[in] expressionData expressionData[numRows][numCols].  Left
+ * unchanged; a ranked copy is made.
+ *
+ * @return The numRows x numRows triangle, 1 on the diagonal.
+ **********************************************************************/
+extern UpperDiagonalSquareMatrix<f64>
+calculateSpearmanCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData);
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
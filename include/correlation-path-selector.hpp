@@ -0,0 +1,184 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Choose between the cross reference and brute force strategies
+used by the correlation matrix engines.
+
+The cross reference path computes only the requested rows against
+every row.  The brute force path computes the whole upper triangle and
+then copies the requested rows out of it.  Which one is cheaper depends
+on the row count, column count, number of requested rows and number of
+threads, so the choice is made from a cost model whose constants are
+measured once on the running machine and cached on disk.  The cost of
+one pair is measured separately for each engine's kernel, as a Kendall
+pair and a Pearson pair of the same length cost different amounts.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//ENUMS AND STRUCTS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Strategies available to the correlation matrix engines.
+ **********************************************************************/
+enum correlationPath{
+  CORRELATION_PATH_CROSS_REFERENCE,
+  CORRELATION_PATH_BRUTE_FORCE
+};
+
+
+/***********************************************************************
+ * Per pair kernels with separately measured costs.  The Spearman engine
+ * uses the Pearson kernel on ranks.
+ **********************************************************************/
+enum correlationKernel{
+  CORRELATION_KERNEL_PEARSON,
+  CORRELATION_KERNEL_KENDALL,
+  CORRELATION_KERNELS
+};
+
+
+/***********************************************************************
+ * Number of column counts at which the per pair cost is sampled.
+ **********************************************************************/
+constexpr const size_t COST_MODEL_SAMPLES = 8;
+
+
+/***********************************************************************
+ * Measured machine constants, all in nanoseconds.
+ **********************************************************************/
+struct correlationCostModel{
+  //Column counts at which pairCost was sampled, ascending.
+  size_t sampleColumns[COST_MODEL_SAMPLES];
+  //Time for kernel k to correlate one pair of rows of sampleColumns[i]
+  //columns is pairCost[k][i].
+  f64 pairCost[CORRELATION_KERNELS][COST_MODEL_SAMPLES];
+  //Time to store one value into an UpperDiagonalSquareMatrix.
+  f64 triangleStoreCost;
+  //Time to copy one value out of an UpperDiagonalSquareMatrix while
+  //walking a row that crosses the packed storage column-wise.
+  f64 extractionCost;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Pick the cheaper correlation strategy using the cached machine
+ * cost model, calibrating and saving it first if needed.
+ *
+ * @param[in] kernel The engine's per pair kernel.
+ *
+ * @param[in] numRows Number of rows in the expression data.
+ *
+ * @param[in] numCols Number of columns in the expression data.
+ *
+ * @param[in] againstRowsLength Number of rows requested, or numRows if
+ * the full matrix is wanted.
+ *
+ * @param[in] numThreads Number of workers the job will be split over.
+ **********************************************************************/
+correlationPath selectCorrelationPath(correlationKernel kernel,
+                        csize_t numRows, csize_t numCols,
+                        csize_t againstRowsLength, csize_t numThreads);
+
+
+/*******************************************************************//**
+ * \brief Pick the cheaper correlation strategy using an explicit cost
+ * model.
+ **********************************************************************/
+correlationPath selectCorrelationPath(const correlationCostModel &model,
+                        correlationKernel kernel,
+                        csize_t numRows, csize_t numCols,
+                        csize_t againstRowsLength, csize_t numThreads);
+
+
+/*******************************************************************//**
+ * \brief Estimated run time in nanoseconds of a strategy under a model.
+ **********************************************************************/
+f64 estimateCorrelationPathCost(const correlationCostModel &model,
+                        correlationKernel kernel,
+                        correlationPath path, csize_t numRows,
+                        csize_t numCols, csize_t againstRowsLength,
+                                                  csize_t numThreads);
+
+
+/*******************************************************************//**
+ * \brief The process wide cost model.  On first use it is read from
+ * correlationCostModelPath(); if that fails the machine is calibrated
+ * with calibrateCorrelationCostModel() and the result written back.
+ **********************************************************************/
+const correlationCostModel& getCorrelationCostModel();
+
+
+/*******************************************************************//**
+ * \brief Run the micro-benchmarks behind the cost model.  Takes on the
+ * order of tens of milliseconds.
+ **********************************************************************/
+correlationCostModel calibrateCorrelationCostModel();
+
+
+/*******************************************************************//**
+ * \brief Location of the on disk cost model cache.  This is
+ * $MADLIB_COST_MODEL if set, otherwise
+ * $XDG_CACHE_HOME/madlib/correlation-cost-model, otherwise
+ * $HOME/.cache/madlib/correlation-cost-model.  Empty if none of those
+ * can be determined.
+ **********************************************************************/
+std::string correlationCostModelPath();
+
+
+/*******************************************************************//**
+ * \brief Read a cost model from a file.
+ *
+ * @return true if the file existed and was a valid model.
+ **********************************************************************/
+bool loadCorrelationCostModel(const std::string &path,
+                                          correlationCostModel &model);
+
+
+/*******************************************************************//**
+ * \brief Write a cost model to a file, creating its directory if
+ * needed.
+ *
+ * @return true on success.
+ **********************************************************************/
+bool saveCorrelationCostModel(const std::string &path,
+                                    const correlationCostModel &model);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
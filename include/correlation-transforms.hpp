@@ -0,0 +1,111 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Convert Pearson correlation coefficients into Fisher z scores, t
+statistics or two sided p-values, in place and in parallel.
+
+The fast paths avoid per element calls into libm so the loops can be
+vectorized:
+  - Fisher z uses a branch free atanh built from an exponent/mantissa
+    split and an odd polynomial, with relative error below 1e-14.
+  - t statistics are r * sqrt(df / (1 - r^2)) in both modes, which is
+    exact to rounding.
+  - p-values are I_(1-r^2)(df/2, 1/2).  Their log, less its dominant
+    term (df/2) log(1 - r^2), is smooth in r, so it is tabulated once
+    per call from the exact function and cubically interpolated.  The
+    table is checked against the exact function at the quarter points
+    of every interval when built, and refined until the relative error
+    of p there is below CORRELATION_P_VALUE_TOLERANCE; if that cannot
+    be reached, or there are too few values to repay building it, the
+    exact path is used.  Values that underflow double precision
+    become 0.
+The exact paths call atanh() and regularizedIncompleteBeta() per value.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <short-primatives.h>
+#include <upper-diagonal-square-matrix.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//ENUMS AND CONSTANTS///////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Quantities a correlation coefficient can be converted to.
+ **********************************************************************/
+enum correlationTransform{
+  CORRELATION_TO_FISHER_Z,
+  CORRELATION_TO_T_STATISTIC,
+  CORRELATION_TO_P_VALUE
+};
+
+
+/***********************************************************************
+ * Largest relative error the fast p-value path accepts from its table.
+ **********************************************************************/
+constexpr const f64 CORRELATION_P_VALUE_TOLERANCE = 1e-10;
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Convert an array of correlation coefficients in place.
+ *
+ * @param[in, out] values Coefficients in [-1, 1]; slightly outside is
+ * taken as +-1.  NaN stays NaN.
+ *
+ * @param[in] count Number of values.
+ *
+ * @param[in] numSamples Number of samples each coefficient was computed
+ * from.  t statistics and p-values use numSamples - 2 degrees of
+ * freedom, and are NaN if that is not positive.
+ *
+ * @param[in] transform What to convert to.
+ *
+ * @param[in] exact Use libm and the exact incomplete beta function for
+ * every value instead of the fast approximations.
+ **********************************************************************/
+void transformCorrelations(f64 *values, csize_t count, csize_t numSamples,
+                const correlationTransform transform, const bool exact);
+
+
+/*******************************************************************//**
+ * \brief Convert every stored element of a correlation matrix in place,
+ * as transformCorrelations().  The diagonal, holding 1, becomes
+ * infinity, infinity or 0 respectively.
+ **********************************************************************/
+void transformCorrelationMatrix(UpperDiagonalSquareMatrix<f64> &matrix,
+              csize_t numSamples, const correlationTransform transform,
+                                                    const bool exact);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,107 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Per row tests for a difference in means between groups of
+columns: Student's and Welch's t-tests and one-way ANOVA.
+
+Every row is read once.  Columns are first gathered so each group is
+contiguous, then one fused loop per group accumulates the count, sum
+and sum of squares (shifted by the row's first value to avoid
+cancellation), from which every test is derived.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//ENUMS AND STRUCTS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Tests calculateGroupTests() can run.
+ **********************************************************************/
+enum groupTest{
+  //Two groups, pooled variance.
+  STUDENT_T_TEST,
+  //Two groups, unequal variances with Welch-Satterthwaite degrees of
+  //freedom.
+  WELCH_T_TEST,
+  //Any number of groups.
+  ONE_WAY_ANOVA
+};
+
+
+/***********************************************************************
+ * Results of a test over every row, one array per quantity, element i
+ * describing row i.  Rows for which a test is undefined (a group too
+ * small, or zero variance) hold NaN.
+ **********************************************************************/
+struct groupTestResults{
+  //t for the t-tests, mean of group 0 minus mean of group 1 over its
+  //standard error; F for ANOVA.
+  std::vector<f64> statistic;
+  //Degrees of freedom of t, or the denominator (within groups) degrees
+  //of freedom of F.  The numerator degrees of freedom of F are the
+  //number of groups - 1 for every row.
+  std::vector<f64> degreesOfFreedom;
+  //Two sided for the t-tests, upper tail for ANOVA.
+  std::vector<f64> pValue;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Run a test for every row of expressionData, in parallel over
+ * rows.
+ *
+ * @param[in] expressionData Used in [row][column] format.  Every row
+ * must have one value per entry of groups, and no NaN values.
+ *
+ * @param[in] groups Group of each column, numbered from 0.  The t-tests
+ * need exactly groups 0 and 1.  ANOVA ignores numbers with no columns,
+ * so {0, 2} is two groups.
+ *
+ * @param[in] test Which test to run.
+ *
+ * @return The results, or empty arrays if groups does not match the
+ * data or has fewer than two non-empty groups, or for the t-tests,
+ * labels other than 0 and 1.
+ **********************************************************************/
+groupTestResults calculateGroupTests(
+            const std::vector<std::vector<double> > &expressionData,
+            const std::vector<size_t> &groups, const groupTest test);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
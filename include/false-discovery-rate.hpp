@@ -0,0 +1,209 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Benjamini-Hochberg false discovery rate control over more
+p-values than can be sorted in memory.
+
+BH rejects every p-value at or below the largest p(k), in sorted order,
+with p(k) <= k q / m.  Rather than sorting, BenjaminiHochbergThreshold
+finds that cut off by streaming over the p-values a few times.  Each
+pass histograms the values falling in the range still in doubt into
+buckets of equal width in IEEE bit pattern (so roughly logarithmic in
+value), and from the cumulative counts narrows the range to the buckets
+which may still hold the cut off.  Once few enough values remain in
+range they are gathered and the cut off is found exactly, so the result
+is identical to sorting.  Two or three passes are typical.
+
+Usage over data read in chunks, e.g. shards on disk:
+
+  BenjaminiHochbergThreshold bh(0.05);
+  while(!bh.isResolved()){
+    bh.beginPass();
+    for(each chunk) bh.add(chunk, chunkSize);
+    bh.endPass();
+  }
+  then reject every p <= bh.getThreshold()
+
+Threads may each add() to their own copy, made after beginPass(), and
+merge() them before endPass().
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <short-primatives.h>
+#include <upper-diagonal-square-matrix.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+class BenjaminiHochbergThreshold{
+  private:
+  f64 q;
+  size_t numBuckets;
+  size_t gatherLimit;
+  //Number of tests, counted on the first pass.
+  size_t m;
+  bool firstPass;
+  bool gathering;
+  bool resolved;
+  f64 threshold;
+  //Range in doubt, as [lowBits, highBits) of IEEE bit patterns.
+  u64 lowBits;
+  u64 highBits;
+  //Number of p-values below lowBits.
+  size_t belowCount;
+  std::vector<size_t> histogram;
+  std::vector<f64> gathered;
+
+  //Lower ranges set aside while a higher one is refined; they are only
+  //searched if the higher one turns out to hold no cut off.
+  struct deferredRange{
+    u64 lowBits;
+    u64 highBits;
+    size_t belowCount;
+    size_t count;
+  };
+  std::vector<deferredRange> deferred;
+
+  void resolveFromHistogram();
+  void resolveFromGathered();
+  bool resumeDeferred();
+
+  public:
+
+/*******************************************************************//**
+ * \brief Prepare to find the BH cut off at false discovery rate q.
+ *
+ * @param[in] q Target false discovery rate, in (0, 1].
+ *
+ * @param[in] numBuckets Histogram buckets per pass, at least 2.
+ *
+ * @param[in] gatherLimit Once at most this many p-values remain in
+ * doubt they are gathered and sorted rather than histogrammed again.
+ **********************************************************************/
+  BenjaminiHochbergThreshold(cf64 q, csize_t numBuckets = 1 << 16,
+                                      csize_t gatherLimit = 1 << 22);
+
+
+/***********************************************************************
+ * Whether the cut off is known, so no more passes are needed.
+ **********************************************************************/
+  bool isResolved() const;
+
+
+/***********************************************************************
+ * Start a pass over every p-value.
+ **********************************************************************/
+  void beginPass();
+
+
+/***********************************************************************
+ * Feed some of the p-values to the current pass.  NaN values are not
+ * counted as tests; values above 1 count as 1.  Every pass must see
+ * the same values, in any order and chunking.
+ **********************************************************************/
+  void add(cf64 *pValues, csize_t count);
+
+
+/***********************************************************************
+ * Fold in the values another copy of this object was fed during the
+ * same pass.
+ **********************************************************************/
+  void merge(const BenjaminiHochbergThreshold &other);
+
+
+/***********************************************************************
+ * Finish a pass, narrowing the range in doubt or resolving the cut off.
+ **********************************************************************/
+  void endPass();
+
+
+/***********************************************************************
+ * The cut off: reject every p-value <= this.  Negative if nothing is
+ * rejected.  Only meaningful once isResolved().
+ **********************************************************************/
+  f64 getThreshold() const;
+
+
+/***********************************************************************
+ * Number of tests seen on the first pass.
+ **********************************************************************/
+  size_t getNumberOfTests() const;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief BH cut off for an array of p-values held in memory, with each
+ * pass run in parallel.
+ **********************************************************************/
+f64 getBenjaminiHochbergThreshold(cf64 *pValues, csize_t count, cf64 q);
+
+
+/*******************************************************************//**
+ * \brief BH cut off for the p-values of every distinct pair held in a
+ * matrix, with each pass run in parallel.  The diagonal is not a test
+ * and is skipped.
+ **********************************************************************/
+f64 getBenjaminiHochbergThreshold(
+                UpperDiagonalSquareMatrix<f64> &pValues, cf64 q);
+
+
+/*******************************************************************//**
+ * \brief Flag the p-values at or below threshold, in parallel.
+ *
+ * @param[out] rejected rejected[i] is set to 1 if pValues[i] is
+ * rejected and 0 otherwise.
+ *
+ * @return The number rejected.
+ **********************************************************************/
+size_t markBenjaminiHochbergRejections(cf64 *pValues, csize_t count,
+                                      cf64 threshold, u8 *rejected);
+
+
+/*******************************************************************//**
+ * \brief Flag the pairs whose p-value is at or below threshold, in
+ * parallel.  The diagonal is never flagged.
+ *
+ * @param[out] rejected Same side length as pValues.
+ *
+ * @return The number of pairs rejected.
+ **********************************************************************/
+size_t markBenjaminiHochbergRejections(
+            UpperDiagonalSquareMatrix<f64> &pValues, cf64 threshold,
+                            UpperDiagonalSquareMatrix<u8> &rejected);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
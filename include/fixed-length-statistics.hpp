@@ -0,0 +1,123 @@
+/*Copyright 2016-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of Madlib.
+
+    Madlib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Madlib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Madlib.  If not, see <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Statistical kernels specialized at compile time on the number of
+elements in each array.  Small studies (few samples per row) spend most
+of their time in loop overhead and tail handling, so these are fully
+unrolled and keep whole rows in registers.  Use
+selectSumOfMultipliedArrays() and selectPinnedSumsOfMultipliedArrays()
+in statistics.hpp to pick one at runtime.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//CONSTANTS/////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Largest array length for which a specialized kernel is instantiated.
+ **********************************************************************/
+constexpr const size_t MAX_FIXED_KERNEL_LENGTH = 64;
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DECLARATIONS////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ *  Calculate sum of multiplied same index values in 2 arrays of exactly
+ * N elements.
+ *
+ * @param[in] left Array of N values.
+ * @param[in] right Array of N values.
+ **********************************************************************/
+template<size_t N> f64 getSumOfMultipliedArraysFixed(cf64 *left,
+                                                            cf64 *right);
+
+
+/*******************************************************************//**
+ *  Calculate the sum of multiplied arrays between one pinned array and
+ * each of a number of other arrays, all N elements long.  The pinned
+ * array is loaded once and held in registers for every row.
+ *
+ * @param[in] pinned Array of N values reused against every row.
+ * @param[in] rows Array of numRows pointers to arrays of N values.
+ * @param[in] numRows Number of entries in rows and results.
+ * @param[out] results results[i] receives the cross sum of pinned and
+ * rows[i].
+ **********************************************************************/
+template<size_t N> void getPinnedSumsOfMultipliedArraysFixed(
+                            cf64 *pinned, cf64 * const *rows,
+                                    csize_t numRows, f64 *results);
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DEFINITIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Four independent accumulators break the add dependency chain; the
+//constant trip count lets the compiler drop the tail loop entirely.
+template<size_t N> f64 getSumOfMultipliedArraysFixed(cf64 *left,
+                                                            cf64 *right){
+  f64 acc[4] = {0, 0, 0, 0};
+
+  #pragma GCC unroll 64
+  for(size_t i = 0; i < N; i++)
+    acc[i % 4] += left[i] * right[i];
+
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+
+template<size_t N> void getPinnedSumsOfMultipliedArraysFixed(
+                            cf64 *pinned, cf64 * const *rows,
+                                    csize_t numRows, f64 *results){
+  f64 kept[N];
+
+  #pragma GCC unroll 64
+  for(size_t i = 0; i < N; i++)
+    kept[i] = pinned[i];
+
+  for(size_t r = 0; r < numRows; r++){
+    cf64 *row = rows[r];
+    f64 acc[4] = {0, 0, 0, 0};
+
+    #pragma GCC unroll 64
+    for(size_t i = 0; i < N; i++)
+      acc[i % 4] += kept[i] * row[i];
+
+    results[r] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
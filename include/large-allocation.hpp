@@ -0,0 +1,127 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Allocation for large matrices: backed by transparent huge pages
+where possible, and first touched in parallel so that each page lands
+on the NUMA node of the worker which will use it.
+
+Linux places a page on the node of the thread that first writes it.
+firstTouchZero() zeroes memory split between the autoThreadLauncher()
+workers as (size * numerator) / denominator, the same fractions the
+correlation helpers use over numberOfElements(), so each worker later
+writes mostly pages on its own node.  Unless MADLIB_CPU_LIST pins the
+pool workers (see threadsArePinned()), this holds only for as long as
+the scheduler leaves them where they started.  Even pinned, a share
+goes to whichever worker claims it first, so the placement is a
+tendency rather than a guarantee.
+
+Huge pages may be turned off by setting MADLIB_HUGE_PAGES=0.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <vector>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Allocate size bytes.  At least one huge page's worth is
+ * aligned to a huge page and advised to use huge pages.  Release with
+ * free().  The memory is not touched.
+ *
+ * @return NULL on failure.
+ **********************************************************************/
+void *allocateLarge(csize_t size);
+
+
+/*******************************************************************//**
+ * \brief Zero memory in parallel, each worker taking the same share as
+ * in the correlation helpers, so that pages are first touched where
+ * they will be used.
+ **********************************************************************/
+void firstTouchZero(void *memory, csize_t size);
+
+
+/*******************************************************************//**
+ * \brief Reallocate each row of data from the worker that takes that
+ * row in an even split of the rows, as parallelFor() with grain 0 gives.
+ * Contents are unchanged.
+ *
+ * Only per row passes with that split, such as centering, then find
+ * their rows on their own node.  The correlation kernels read every row
+ * from every worker, so for them this only spreads the rows across the
+ * nodes rather than placing each next to its reader.
+ **********************************************************************/
+void distributeRows(std::vector<std::vector<double> > &data);
+
+
+/***********************************************************************
+ * Whether allocateLarge() asks for huge pages.
+ **********************************************************************/
+bool hugePagesEnabled();
+
+
+////////////////////////////////////////////////////////////////////////
+//ALLOCATOR DEFINITION//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Standard allocator over allocateLarge(), for containers which should
+ * use the same policy.  Like allocateLarge(), allocate() returns NULL
+ * on failure rather than throwing.
+ **********************************************************************/
+template<typename T> class largeAllocator{
+  public:
+  typedef T value_type;
+
+  largeAllocator(){}
+  template<typename U> largeAllocator(const largeAllocator<U>&){}
+
+  T *allocate(csize_t count){
+    return (T*) allocateLarge(count * sizeof(T));
+  }
+
+  void deallocate(T *memory, csize_t){ free(memory); }
+
+  template<typename U> bool operator==(const largeAllocator<U>&) const{
+    return true;
+  }
+
+  template<typename U> bool operator!=(const largeAllocator<U>&) const{
+    return false;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
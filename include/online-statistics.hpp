@@ -0,0 +1,212 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Accumulators for moments and co-moments of data which arrives a
+value or a chunk at a time.
+
+Each accumulator can be fed values with push(), and two accumulators
+built over disjoint parts of the same data can be combined with
+merge(), giving the same result (up to rounding) as one accumulator fed
+everything.  Updates follow Welford's recurrence and merges follow Chan
+et al. as generalized to higher moments by Pebay, so neither loses
+precision to large means.  This lets threads, or a streaming reader,
+summarize their share of rows or columns independently and combine
+afterwards.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITIONS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Count, mean, second through fourth central moments, minimum and
+ * maximum of one variable.  NaN values are counted and otherwise
+ * ignored.  Statistics which are undefined for the data seen so far
+ * are returned as NaN.
+ **********************************************************************/
+class OnlineMoments{
+  private:
+  size_t count;
+  size_t nanCount;
+  f64 mean;
+  f64 m2;
+  f64 m3;
+  f64 m4;
+  f64 minimum;
+  f64 maximum;
+
+  public:
+
+/***********************************************************************
+ * Create an accumulator which has seen no values.
+ **********************************************************************/
+  OnlineMoments();
+
+
+/***********************************************************************
+ * Add one value.
+ **********************************************************************/
+  void push(cf64 value);
+
+
+/***********************************************************************
+ * Add size values.
+ **********************************************************************/
+  void push(cf64 *array, csize_t size);
+
+
+/***********************************************************************
+ * Fold in another accumulator's values, as if they had been pushed
+ * here.
+ **********************************************************************/
+  void merge(const OnlineMoments &other);
+
+
+/***********************************************************************
+ * Number of non-NaN values seen.
+ **********************************************************************/
+  size_t getCount() const;
+
+
+/***********************************************************************
+ * Number of NaN values seen.
+ **********************************************************************/
+  size_t getNanCount() const;
+
+
+  f64 getMean() const;
+
+
+/***********************************************************************
+ * Sample variance, dividing by count - 1.
+ **********************************************************************/
+  f64 getVariance() const;
+
+
+/***********************************************************************
+ * Sample skewness g1 = m3 / m2^(3/2), using biased central moments.
+ **********************************************************************/
+  f64 getSkewness() const;
+
+
+/***********************************************************************
+ * Excess kurtosis g2 = m4 / m2^2 - 3, using biased central moments.
+ **********************************************************************/
+  f64 getKurtosis() const;
+
+
+  f64 getMinimum() const;
+
+
+  f64 getMaximum() const;
+
+
+/***********************************************************************
+ * Sum of squared deviations from the mean.
+ **********************************************************************/
+  f64 getSecondMoment() const;
+};
+
+
+/***********************************************************************
+ * Count, means, co-moment and second moments of a pair of variables
+ * observed together.  Pairs in which either value is NaN are skipped.
+ **********************************************************************/
+class OnlineCovariance{
+  private:
+  size_t count;
+  f64 meanX;
+  f64 meanY;
+  f64 m2X;
+  f64 m2Y;
+  f64 coMoment;
+
+  public:
+
+/***********************************************************************
+ * Create an accumulator which has seen no pairs.
+ **********************************************************************/
+  OnlineCovariance();
+
+
+/***********************************************************************
+ * Add one pair.
+ **********************************************************************/
+  void push(cf64 x, cf64 y);
+
+
+/***********************************************************************
+ * Add the pairs (x[i], y[i]) for i < size.
+ **********************************************************************/
+  void push(cf64 *x, cf64 *y, csize_t size);
+
+
+/***********************************************************************
+ * Fold in another accumulator's pairs, as if they had been pushed
+ * here.
+ **********************************************************************/
+  void merge(const OnlineCovariance &other);
+
+
+/***********************************************************************
+ * Number of pairs seen.
+ **********************************************************************/
+  size_t getCount() const;
+
+
+  f64 getMeanX() const;
+
+
+  f64 getMeanY() const;
+
+
+/***********************************************************************
+ * Sum of products of deviations from the means.
+ **********************************************************************/
+  f64 getCoMoment() const;
+
+
+/***********************************************************************
+ * Sample covariance, dividing by count - 1.
+ **********************************************************************/
+  f64 getCovariance() const;
+
+
+/***********************************************************************
+ * Pearson correlation coefficient.
+ **********************************************************************/
+  f64 getCorrelation() const;
+};
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
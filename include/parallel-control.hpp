@@ -0,0 +1,175 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Cancelling and following the progress of long parallel jobs.
+
+A caller installs a ParallelControl on its thread for the duration of a
+call such as calculatePearsonCorrelationMatrix().  The thread pool
+carries it to every job launched from that thread, and from those jobs
+in turn, so workers see it without it being passed down explicitly.
+
+Workers call parallelCancelled() between tiles (a row, a block of rows
+or a checkpoint tile) and stop early once the token is cancelled.  Only
+those calls check: the shared primitives (autoThreadLauncher(),
+parallelFor(), TaskGraph, the sorts and the helpers built on them)
+always finish, since their callers cannot tell a partial result from a
+whole one; a sort stopped early would hand the FDR and quantile code an
+unsorted array.  A cancelled call returns an empty result; anything it
+would have modified in place is left partly done.
+
+Each stage of a job that reports progress first calls
+beginParallelProgress() with its amount of work, then its workers call
+reportParallelProgress() as tiles finish.  The callback is told the
+stage, as named by the innermost ParallelRegion, and how much of it is
+done.
+
+Without a ParallelControl each check is one thread local load.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <mutex>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//TYPEDEFS//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Called with the stage name, the work done in that stage so far and
+ * its total.  Calls for one ParallelControl never overlap, but may come
+ * from any worker thread, so it should be quick.
+ **********************************************************************/
+typedef void (*parallelProgressCallback)(const char *stage,
+                  csize_t completed, csize_t total, void *context);
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITIONS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * A flag any thread may raise to stop the jobs watching it.
+ **********************************************************************/
+class CancellationToken{
+  private:
+  std::atomic<bool> cancelled;
+
+  public:
+  CancellationToken();
+
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  void cancel();
+  bool isCancelled() const;
+  void reset();
+};
+
+
+/***********************************************************************
+ * Watch token and report progress to callback for the parallel work
+ * launched by this thread until destruction.  One job at a time per
+ * ParallelControl; the token may be shared.
+ **********************************************************************/
+class ParallelControl{
+  private:
+  CancellationToken *token;
+  parallelProgressCallback callback;
+  void *context;
+  ParallelControl *previous;
+
+  std::mutex progressLock;
+  const char *stage;
+  size_t total;
+  std::atomic<size_t> completed;
+
+  public:
+
+/*******************************************************************//**
+ * \brief Install on the calling thread.
+ *
+ * @param[in] token May be NULL to only follow progress.
+ *
+ * @param[in] callback May be NULL to only allow cancelling.
+ *
+ * @param[in] context Passed to callback.
+ **********************************************************************/
+  explicit ParallelControl(CancellationToken *token,
+                           parallelProgressCallback callback = NULL,
+                           void *context = NULL);
+  ~ParallelControl();
+
+  ParallelControl(const ParallelControl&) = delete;
+  ParallelControl& operator=(const ParallelControl&) = delete;
+
+  bool isCancelled() const;
+  void beginProgress(const char *stage, csize_t total);
+  void addProgress(csize_t amount);
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Whether the work on this thread should stop.
+ **********************************************************************/
+bool parallelCancelled();
+
+
+/***********************************************************************
+ * Start a stage of total units of work, named by currentParallelRegion().
+ **********************************************************************/
+void beginParallelProgress(csize_t total);
+
+
+/***********************************************************************
+ * Credit amount units of the current stage as done.
+ **********************************************************************/
+void reportParallelProgress(csize_t amount);
+
+
+/***********************************************************************
+ * The ParallelControl in effect on this thread, or NULL.
+ **********************************************************************/
+ParallelControl *currentParallelControl();
+
+
+/***********************************************************************
+ * Put control in effect on this thread and return the one it replaces.
+ * Used by the thread pool to carry a control over to its workers.
+ **********************************************************************/
+ParallelControl *swapParallelControl(ParallelControl *control);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
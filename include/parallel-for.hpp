@@ -0,0 +1,210 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Typed parallel loops over an index range, built on
+autoThreadLauncher().
+
+The loop body is a callable taking a half open chunk [first, last), so
+it is instantiated into the worker and its inner loop can be inlined
+and vectorized.  No helper struct or void* cast is needed.
+
+With a grain of 0 each worker takes one contiguous share,
+[(n * numerator) / denominator, (n * (numerator+1)) / denominator),
+exactly as the hand written helpers do, so the same worker touches the
+same part of an array in both.  With a non-zero grain the range is cut
+into chunks of grain indices which workers claim in turn, for bodies
+whose cost varies along the range.
+
+parallelReduce() combines the chunk results in chunk order, so for a
+given grain and thread count the result is the same from run to run
+even when the combining operation is not associative, as with floating
+point addition.
+
+Every chunk is run even if parallelCancelled(), so the result never
+covers only part of the range; a body which should stop early checks
+for itself.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <vector>
+
+#include <parallel-profile.hpp>
+#include <short-primatives.h>
+#include <simple-thread-dispatch.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DECLARATIONS////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Call body(first, last) over chunks covering [begin, end) in
+ * parallel.
+ *
+ * @param[in] grain Chunk size, or 0 for one equal share per worker.
+ *
+ * @param[in] body Callable as body(size_t first, size_t last).  Called
+ * concurrently on disjoint chunks.
+ **********************************************************************/
+template<typename Body> void parallelFor(csize_t begin, csize_t end,
+                                          csize_t grain, Body body);
+
+
+/*******************************************************************//**
+ * \brief Reduce [begin, end) in parallel.
+ *
+ * @param[in] grain Chunk size, or 0 for one equal share per worker.
+ *
+ * @param[in] identity Result of an empty range.
+ *
+ * @param[in] body Callable as R body(size_t first, size_t last),
+ * returning the result for one chunk.
+ *
+ * @param[in] combine Callable as R combine(R left, R right), left
+ * holding the earlier chunks.
+ **********************************************************************/
+template<typename R, typename Body, typename Combine> R parallelReduce(
+                  csize_t begin, csize_t end, csize_t grain,
+                        const R identity, Body body, Combine combine);
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STRUCTS AND TEMPLATE FUNCTIONS////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Body here is called as body(chunk, first, last); with grain 0 the
+//chunk number is the worker's numerator.
+template<typename Body> struct parallelForStruct{
+  size_t begin;
+  size_t end;
+  size_t grain;
+  std::atomic<size_t> nextChunk;
+  Body *body;
+};
+
+
+template<typename Body> void *parallelForHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  parallelForStruct<Body> *args =
+                          (parallelForStruct<Body>*) arg->specifics;
+  csize_t begin = args->begin;
+  csize_t length = args->end - begin;
+  csize_t grain = args->grain;
+
+  if(0 == grain){
+    csize_t minimum = begin + (length * numerator) / denominator;
+    csize_t maximum = begin + (length * (numerator+1)) / denominator;
+    if(minimum < maximum){
+      (*args->body)(numerator, minimum, maximum);
+      countParallelItems(maximum - minimum);
+    }
+    return NULL;
+  }
+
+  csize_t numChunks = (length + grain-1) / grain;
+  for(size_t chunk = args->nextChunk++; chunk < numChunks;
+                                          chunk = args->nextChunk++){
+    csize_t first = begin + chunk * grain;
+    csize_t last = first + grain < args->end ? first + grain : args->end;
+    (*args->body)(chunk, first, last);
+    countParallelItems(last - first);
+  }
+
+  return NULL;
+}
+
+
+//Splits between numThreads workers, so with grain 0 the chunk number is
+//always below numThreads.
+template<typename Body> void parallelForChunks(csize_t begin,
+      csize_t end, csize_t grain, Body &body, csize_t numThreads){
+  parallelForStruct<Body> instructions;
+  instructions.begin = begin;
+  instructions.end = end;
+  instructions.grain = grain;
+  instructions.nextChunk = 0;
+  instructions.body = &body;
+
+  autoThreadLauncher(parallelForHelper<Body>, (void*) &instructions,
+                                                          numThreads);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DEFINITIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Body> void parallelFor(csize_t begin, csize_t end,
+                                          csize_t grain, Body body){
+  if(begin >= end) return;
+
+  auto chunkBody = [&body](csize_t, csize_t first, csize_t last){
+    body(first, last);
+  };
+  parallelForChunks(begin, end, grain, chunkBody, autoThreadCount());
+}
+
+
+template<typename R, typename Body, typename Combine> R parallelReduce(
+                  csize_t begin, csize_t end, csize_t grain,
+                        const R identity, Body body, Combine combine){
+  if(begin >= end) return identity;
+
+  //One result slot per chunk; with grain 0 a chunk is a worker's share,
+  //and the same count of workers is launched.
+  csize_t length = end - begin;
+  csize_t numThreads = autoThreadCount();
+  csize_t numChunks = 0 == grain ? numThreads
+                                  : (length + grain-1) / grain;
+  std::vector<R> partials(numChunks, identity);
+  std::vector<u8> present(numChunks, 0);
+
+  auto chunkBody = [&](csize_t chunk, csize_t first, csize_t last){
+    partials[chunk] = body(first, last);
+    present[chunk] = 1;
+  };
+  parallelForChunks(begin, end, grain, chunkBody, numThreads);
+
+  R tr = identity;
+  bool any = false;
+  for(size_t i = 0; i < numChunks; i++){
+    if(!present[i]) continue;
+    tr = any ? combine(tr, partials[i]) : partials[i];
+    any = true;
+  }
+
+  return tr;
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,185 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Timing of parallel regions, to see how evenly work is split
+between workers without attaching a profiler.
+
+While profiling is on, each autoThreadLauncher() call (and so each
+parallelFor() and parallelReduce()) and each TaskGraph::run() is
+recorded under the name of the innermost ParallelRegion on the calling
+thread: its wall time, and for each share (worker numerator, or for a
+task graph each thread which ran tasks) the time spent working and the
+number of items counted with countParallelItems().  Jobs launched from
+inside a share are recorded under the same name.
+
+Profiling is off unless turned on with setParallelProfiling() or by
+setting MADLIB_PROFILE=1, which also prints printParallelProfile() to
+stderr when the process exits.  While off, a launch costs one extra
+atomic load.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//STRUCT DEFINITIONS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Totals for every launch under one region name.
+ **********************************************************************/
+struct parallelRegionProfile{
+  std::string name;
+  size_t launches;
+  //Sum over launches of the launching thread's wall time.
+  f64 wallSeconds;
+  //Per share, summed over launches.
+  std::vector<f64> busySeconds;
+  std::vector<u64> items;
+};
+
+
+/***********************************************************************
+ * One share of a profiled launch, as passed to profiledShare(), which
+ * calls func(load) and fills in the totals.
+ **********************************************************************/
+struct profiledLoad{
+  struct multithreadLoad *load;
+  void* (*func)(void*);
+  const char *region;
+  f64 busySeconds;
+  u64 items;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Name the parallel work launched by this thread until destruction.
+ * name must outlive the object; a string literal is typical.
+ **********************************************************************/
+class ParallelRegion{
+  private:
+  const char *previous;
+
+  public:
+  explicit ParallelRegion(const char *name);
+  ~ParallelRegion();
+
+  ParallelRegion(const ParallelRegion&) = delete;
+  ParallelRegion& operator=(const ParallelRegion&) = delete;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Whether launches are being recorded.
+ **********************************************************************/
+bool parallelProfilingEnabled();
+
+
+/***********************************************************************
+ * Start or stop recording.  Records so far are kept.
+ **********************************************************************/
+void setParallelProfiling(const bool enabled);
+
+
+/***********************************************************************
+ * Name of the innermost ParallelRegion on this thread, or "unnamed".
+ **********************************************************************/
+const char *currentParallelRegion();
+
+
+/***********************************************************************
+ * Credit count items to the share this thread is running, if profiled.
+ **********************************************************************/
+void countParallelItems(csize_t count);
+
+
+/***********************************************************************
+ * Every region recorded so far, the longest wall time first.
+ **********************************************************************/
+std::vector<parallelRegionProfile> getParallelProfile();
+
+
+/***********************************************************************
+ * Forget every record.
+ **********************************************************************/
+void resetParallelProfile();
+
+
+/*******************************************************************//**
+ * \brief Write one line per region: launches, wall and busy seconds,
+ * shares, imbalance (busiest share over the mean share, 1 is even) and
+ * efficiency (busy time over wall time times shares).
+ **********************************************************************/
+void printParallelProfile(FILE *stream);
+
+
+/*******************************************************************//**
+ * \brief Run one share of a profiled launch: time it and collect its
+ * items.  Used with ThreadPool::submit() by autoThreadLauncher().
+ **********************************************************************/
+void *profiledShare(void *protoArgs);
+
+
+/*******************************************************************//**
+ * \brief Add one launch of a region to the records.
+ *
+ * @param[in] busySeconds Time each share spent working.
+ *
+ * @param[in] items Items counted by each share.
+ **********************************************************************/
+void recordParallelRegion(const char *name, cf64 wallSeconds,
+          const std::vector<f64> &busySeconds, const std::vector<u64> &items);
+
+
+/***********************************************************************
+ * A small number unique to the calling thread, for per thread totals.
+ **********************************************************************/
+size_t parallelProfileThreadSlot();
+
+
+/***********************************************************************
+ * Seconds on a monotonic clock.
+ **********************************************************************/
+f64 parallelProfileClock();
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
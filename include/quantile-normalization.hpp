@@ -0,0 +1,59 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Quantile normalize the samples (columns) of an expression matrix.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Replace every value by the mean, over all columns, of the
+ * values holding the same rank in their column, so that every column
+ * ends up with the same distribution.  Values tied within a column all
+ * receive the average of the reference values over the ranks they span.
+ *
+ * Work is done in place and in parallel over columns.  Each column is
+ * sorted twice, once to build the reference distribution and once to
+ * scatter it back, so that no sorted copy of the matrix is kept; extra
+ * memory is about two columns (2 x numRows values) per thread, a
+ * partial sum and a sort buffer.
+ *
+ * @param[in, out] expressionData Used in [row][column] format.  Every
+ * row must have the same length and contain no NaN values.
+ **********************************************************************/
+void quantileNormalize(std::vector<std::vector<double> > &expressionData);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
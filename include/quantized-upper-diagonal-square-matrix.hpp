@@ -0,0 +1,244 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief An UpperDiagonalSquareMatrix of correlations held as fixed point
+integers rather than doubles.
+
+Values in [-1, 1] are stored as round(v * S) in a signed integer type Q,
+where S is the largest value of Q: 127 for s8, 32767 for s16.  Values
+outside [-1, 1] are clamped.  The most negative code is reserved for
+NaN.  Reading back gives the stored value to within 0.5 / S, that is
+3.9e-3 for s8 and 1.5e-5 for s16 (correlationCodec<Q>::MAX_ERROR).  A
+100,000 row triangle takes 10 GB as s16 or 5 GB as s8, against 40 GB
+as f64.
+
+Whole rows are encoded and decoded by branch free loops the compiler
+vectorizes; prefer setRowSpan() and getRow() to the single value
+accessors in bulk work.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <limits>
+#include <math.h>
+
+#include <short-primatives.h>
+#include <upper-diagonal-square-matrix.hpp>
+
+////////////////////////////////////////////////////////////////////////
+//CODEC DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Q> struct correlationCodec{
+  static_assert(std::numeric_limits<Q>::is_signed
+                                && std::numeric_limits<Q>::is_integer,
+                      "correlationCodec needs a signed integer type");
+
+  static constexpr const Q NAN_CODE = std::numeric_limits<Q>::min();
+  static constexpr const f64 SCALE = std::numeric_limits<Q>::max();
+  static constexpr const f64 MAX_ERROR = 0.5 / SCALE;
+
+
+/***********************************************************************
+ * Quantize one value.
+ **********************************************************************/
+  static Q encode(cf64 value){
+    //NaN fails every comparison, so it is zeroed before the cast and
+    //its code chosen afterwards; the select keeps the loop vectorizable.
+    cf64 clamped = value > 1 ? 1 : (value < -1 ? -1 : (value == value
+                                                          ? value : 0));
+    cs32 code = (s32) (clamped * SCALE + (clamped < 0 ? -0.5 : 0.5));
+    return value == value ? (Q) code : NAN_CODE;
+  }
+
+
+/***********************************************************************
+ * Dequantize one value.
+ **********************************************************************/
+  static f64 decode(const Q code){
+    return code == NAN_CODE ? NAN : code * (1.0 / SCALE);
+  }
+
+
+/***********************************************************************
+ * Quantize count values into codes.
+ **********************************************************************/
+  static void encode(cf64 *values, csize_t count, Q *codes){
+    for(size_t i = 0; i < count; i++) codes[i] = encode(values[i]);
+  }
+
+
+/***********************************************************************
+ * Dequantize count codes into values.
+ **********************************************************************/
+  static void decode(const Q *codes, csize_t count, f64 *values){
+    for(size_t i = 0; i < count; i++) values[i] = decode(codes[i]);
+  }
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Q, typename Layout = RowPackedLayout>
+                                class QuantizedUpperDiagonalSquareMatrix{
+  private:
+  UpperDiagonalSquareMatrix<Q, Layout> codes;
+
+  public:
+
+  typedef correlationCodec<Q> codec;
+
+
+/***********************************************************************
+ *
+ **********************************************************************/
+  QuantizedUpperDiagonalSquareMatrix(size_t sideLength);
+
+
+/***********************************************************************
+ *
+ **********************************************************************/
+  size_t getSideLength();
+
+
+/***********************************************************************
+ *
+ **********************************************************************/
+  f64 getValueAtIndex(size_t x, size_t y);
+
+
+/***********************************************************************
+ *
+ **********************************************************************/
+  void setValueAtIndex(size_t x, size_t y, f64 value);
+
+
+/*******************************************************************//**
+ * \brief Copy out row y of the full symmetric matrix.
+ *
+ * @param[out] row Receives getSideLength() values, row[x] being the
+ * value at (x, y).
+ **********************************************************************/
+  void getRow(size_t y, f64 *row);
+
+
+/*******************************************************************//**
+ * \brief Store the stored part of row y, (y, y) through (n-1, y), in
+ * one go.  Only available for layouts with contiguous rows.
+ *
+ * @param[in] values getSideLength() - y values, (y, y) first.
+ **********************************************************************/
+  void setRowSpan(size_t y, cf64 *values);
+
+
+/***********************************************************************
+ * Quantize every value of a full precision matrix of the same side
+ * length and layout.
+ **********************************************************************/
+  void quantize(UpperDiagonalSquareMatrix<f64, Layout> &source);
+
+
+/***********************************************************************
+ * The underlying matrix of codes, e.g. to save or map it.
+ **********************************************************************/
+  UpperDiagonalSquareMatrix<Q, Layout>& getCodes();
+};
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Q, typename Layout>
+                                QuantizedUpperDiagonalSquareMatrix<Q, Layout>
+          ::QuantizedUpperDiagonalSquareMatrix(size_t sideLength)
+                                                    : codes(sideLength){
+}
+
+
+template<typename Q, typename Layout> size_t
+            QuantizedUpperDiagonalSquareMatrix<Q, Layout>::getSideLength(){
+  return codes.getSideLength();
+}
+
+
+template<typename Q, typename Layout> f64
+                          QuantizedUpperDiagonalSquareMatrix<Q, Layout>
+                              ::getValueAtIndex(size_t x, size_t y){
+  return codec::decode(codes.getValueAtIndex(x, y));
+}
+
+
+template<typename Q, typename Layout> void
+                          QuantizedUpperDiagonalSquareMatrix<Q, Layout>
+                  ::setValueAtIndex(size_t x, size_t y, f64 value){
+  codes.setValueAtIndex(x, y, codec::encode(value));
+}
+
+
+//Left of the diagonal the symmetric row is a strided column; from the
+//diagonal rightward it is contiguous for row packed layouts, and is
+//decoded in bulk.
+template<typename Q, typename Layout> void
+                          QuantizedUpperDiagonalSquareMatrix<Q, Layout>
+                                      ::getRow(size_t y, f64 *row){
+  typename UpperDiagonalSquareMatrix<Q, Layout>::iterator end =
+                                                    codes.columnEnd(y);
+  for(auto it = codes.columnBegin(y); it != end; ++it)
+    row[it.index()] = codec::decode(*it);
+
+  if constexpr(Layout::CONTIGUOUS_ROWS){
+    std::pair<Q*, size_t> span = codes.getRowSpan(y);
+    codec::decode(span.first + 1, span.second - 1, row + y + 1);
+  }else{
+    end = codes.rowEnd(y);
+    for(auto it = ++codes.rowBegin(y); it != end; ++it)
+      row[it.index()] = codec::decode(*it);
+  }
+}
+
+
+template<typename Q, typename Layout> void
+                          QuantizedUpperDiagonalSquareMatrix<Q, Layout>
+                              ::setRowSpan(size_t y, cf64 *values){
+  std::pair<Q*, size_t> span = codes.getRowSpan(y);
+  codec::encode(values, span.second, span.first);
+}
+
+
+template<typename Q, typename Layout> void
+                          QuantizedUpperDiagonalSquareMatrix<Q, Layout>
+            ::quantize(UpperDiagonalSquareMatrix<f64, Layout> &source){
+  codec::encode(source.data(), codes.numberOfElements(), codes.data());
+}
+
+
+template<typename Q, typename Layout> UpperDiagonalSquareMatrix<Q, Layout>&
+                  QuantizedUpperDiagonalSquareMatrix<Q, Layout>::getCodes(){
+  return codes;
+}
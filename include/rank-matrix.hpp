@@ -33,6 +33,9 @@
 #include <unistd.h>
 #include <vector>
 
+#include <async-result.hpp>
+#include <parallel-control.hpp>
+
 
 ////////////////////////////////////////////////////////////////////////
 //PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
@@ -44,10 +47,32 @@
  * becomes their value, maintaining relative high to low ordering.
  *
  * @param[in, out] expressionData Used in [row][column] format, rank the values
- * in each column.
+ * in each column.  If parallelCancelled(), some rows are left unranked.
  **********************************************************************/
 void calculateRankMatrix(std::vector<std::vector<double> > &expressionData);
 
+
+/*******************************************************************//**
+ * \brief As calculateRankMatrix(), but queued on the thread pool with
+ * runAsync(); see async-result.hpp.  expressionData must stay valid
+ * until the result is ready.
+ *
+ * @return A result of true, or false if cancelled part way.
+ **********************************************************************/
+AsyncResult<bool> calculateRankMatrixAsync(
+                          std::vector<std::vector<double> > &expressionData,
+                          CancellationToken *token = NULL,
+                          parallelProgressCallback progress = NULL,
+                          void *context = NULL);
+
+
+/*******************************************************************//**
+ * \brief As calculateRankMatrix(), on rows [first, last) only and on
+ * the calling thread, for callers scheduling the rows themselves.
+ **********************************************************************/
+void calculateRankRows(std::vector<std::vector<double> > &expressionData,
+                                          size_t first, size_t last);
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
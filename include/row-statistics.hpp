@@ -0,0 +1,97 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Per row summary statistics of an expression matrix, computed in
+a single pass over each row.
+
+Each row is read exactly once: the mean and the second through fourth
+central moments are updated together per element by an OnlineMoments
+accumulator, so no separate mean pass is needed and no large sums are
+cancelled.  NaN values are counted and otherwise ignored.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <short-primatives.h>
+
+
+////////////////////////////////////////////////////////////////////////
+//STRUCT DEFINITIONS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Summary statistics for every row of a matrix, one array per statistic
+ * so each can be handed on as a column of results.  Element i of every
+ * array describes row i.  Statistics which are undefined for a row (too
+ * few non-NaN values, or zero variance for skewness and kurtosis) are
+ * NaN.
+ **********************************************************************/
+struct rowStatistics{
+  //Number of non-NaN values.
+  std::vector<size_t> count;
+  //Number of NaN values.
+  std::vector<size_t> nanCount;
+  std::vector<f64> mean;
+  //Sample variance, dividing by count - 1.
+  std::vector<f64> variance;
+  //Sample skewness g1 = m3 / m2^(3/2), using biased central moments.
+  std::vector<f64> skewness;
+  //Excess kurtosis g2 = m4 / m2^2 - 3, using biased central moments.
+  std::vector<f64> kurtosis;
+  std::vector<f64> minimum;
+  std::vector<f64> maximum;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Compute every statistic in rowStatistics for each row of
+ * expressionData, in parallel over rows and in one pass over memory.
+ *
+ * @param[in] expressionData Rows of values.  Rows may differ in length.
+ *
+ * @return Statistics for each row, in row order.
+ **********************************************************************/
+rowStatistics calculateRowStatistics(
+            const std::vector<std::vector<double> > &expressionData);
+
+
+/*******************************************************************//**
+ * \brief Single row form of calculateRowStatistics(), writing into
+ * entry row of results, which must already be sized.
+ **********************************************************************/
+void calculateRowStatistics(cf64 *array, csize_t size,
+                                  rowStatistics &results, csize_t row);
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -20,7 +20,23 @@
 
 /*******************************************************************//**
 @file
-@brief A simple barrier style multithreading system.
+@brief A simple barrier style multithreading system.  Jobs run on the
+persistent workers of getThreadPool() in thread-pool.hpp.
+
+How many workers a job is split between is decided once per process,
+or again whenever the policy below is changed:
+
+  - MADLIB_NUM_THREADS or setThreadCount() fixes the number outright.
+  - Otherwise it is the number of CPUs this process may run on, from
+    sched_getaffinity() or MADLIB_CPU_LIST / setThreadCPUList(), capped
+    by the cgroup CPU quota, if any.
+  - MADLIB_SMT=0 or setUseSMTSiblings(false) keeps only the first
+    hardware thread of each core in that CPU set.
+  - When a CPU list is given explicitly, pool workers are pinned to its
+    CPUs in turn.  The calling thread is never pinned.
+
+The policy may only be changed while no parallel work is running, as
+the pool is restarted to match.
 ***********************************************************************/
 
 #pragma once
@@ -29,6 +45,9 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <string>
+#include <vector>
+
 #include <short-primatives.h>
 
 ////////////////////////////////////////////////////////////////////////
@@ -60,5 +79,80 @@ struct multithreadLoad{
  *
  * @param[in] sharedArgs The shared dataset for the worker function.
  *
+ * The calling thread runs the first share itself.  func may itself call
+ * autoThreadLauncher().  Every share is run even if parallelCancelled();
+ * stopping early is left to func.
  **********************************************************************/
 void autoThreadLauncher(void* (*func)(void*), void *sharedArgs);
+
+
+/*******************************************************************//**
+ * \brief As above, split between exactly numThreads workers.
+ *
+ * A caller with one slot per worker should read autoThreadCount() once,
+ * size its slots from that and pass the same value here, so that a
+ * concurrent setThreadCount() cannot hand out numerators past the end.
+ *
+ * @param[in] numThreads At least 1.
+ **********************************************************************/
+void autoThreadLauncher(void* (*func)(void*), void *sharedArgs,
+                                                csize_t numThreads);
+
+
+/*******************************************************************//**
+ * \brief Number of workers autoThreadLauncher() splits a job between,
+ * and so the denominator every worker will see.
+ **********************************************************************/
+size_t autoThreadCount();
+
+
+/*******************************************************************//**
+ * \brief Fix the number of workers, or with 0 go back to deriving it
+ * from the CPU set and quota.  Overrides MADLIB_NUM_THREADS.
+ **********************************************************************/
+void setThreadCount(csize_t numThreads);
+
+
+/*******************************************************************//**
+ * \brief Restrict workers to a list of CPUs such as "0-7,16-23" and pin
+ * pool workers to them.  An empty list goes back to the inherited
+ * affinity without pinning.  Overrides MADLIB_CPU_LIST.
+ *
+ * @return false, changing nothing, if the list does not parse.
+ **********************************************************************/
+bool setThreadCPUList(const std::string &cpuList);
+
+
+/*******************************************************************//**
+ * \brief Whether more than one hardware thread per core is used.
+ * Default true.  Overrides MADLIB_SMT.
+ **********************************************************************/
+void setUseSMTSiblings(const bool useSMT);
+
+
+/***********************************************************************
+ * CPUs workers may run on under the current policy, ascending.
+ **********************************************************************/
+std::vector<size_t> getThreadCPUs();
+
+
+/***********************************************************************
+ * Whether pool workers are pinned, to getThreadCPUs() in turn.
+ **********************************************************************/
+bool threadsArePinned();
+
+
+/***********************************************************************
+ * CPUs allowed by the cgroup CPU quota, rounded up, or 0 if unlimited
+ * or unknown.
+ **********************************************************************/
+size_t detectCPUQuota();
+
+
+/*******************************************************************//**
+ * \brief Parse a Linux style CPU list, "0-3,8,10-11".
+ *
+ * @return false if the list is malformed or names a CPU of CPU_SETSIZE
+ * or more.
+ **********************************************************************/
+bool parseCPUList(const std::string &cpuList, std::vector<size_t> &cpus);
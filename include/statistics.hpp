@@ -33,6 +33,42 @@
 #include <short-primatives.h>
 
 
+////////////////////////////////////////////////////////////////////////
+//ENUMS AND TYPEDEFS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Instruction sets getSum(), getMean(), getSumOfSquares() and
+ * getSumOfMultipliedArrays() have implementations for, narrowest first.
+ * The widest one the CPU supports is chosen when the library loads.
+ * Setting the environment variable MADLIB_SIMD to scalar, sse2, avx2 or
+ * avx512 caps the choice.
+ **********************************************************************/
+enum simdInstructionSet{
+  SIMD_SCALAR = 0,
+  SIMD_SSE2 = 1,
+  SIMD_AVX2 = 2,
+  SIMD_AVX512 = 3
+};
+
+
+/***********************************************************************
+ * Signature shared by getSumOfMultipliedArrays() and the kernels
+ * returned by selectSumOfMultipliedArrays().
+ **********************************************************************/
+typedef f64 (*sumOfMultipliedArraysFunction)(cf64 *left, cf64 *right,
+                                                          csize_t size);
+
+
+/***********************************************************************
+ * Signature shared by getPinnedSumsOfMultipliedArrays() and the kernels
+ * returned by selectPinnedSumsOfMultipliedArrays().
+ **********************************************************************/
+typedef void (*pinnedSumsOfMultipliedArraysFunction)(cf64 *pinned,
+                          cf64 * const *rows, csize_t numRows,
+                                        csize_t size, f64 *results);
+
+
 ////////////////////////////////////////////////////////////////////////
 //PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -121,6 +157,61 @@ f64  getSumOfSquares(cf64 *array, csize_t size);
 f64  getSumOfMultipliedArrays(cf64 *left, cf64 *right, csize_t size);
 
 
+/*******************************************************************//**
+ *  Calculate sum of multiplied same index values between one array and
+ * each of a number of other arrays.
+ *
+ * @param[in] pinned Array of values reused against every row.
+ * @param[in] rows Array of numRows pointers to arrays of values.
+ * @param[in] numRows Number of entries in rows and results.
+ * @param[in] size Number of elements in pinned and in each row.
+ * @param[out] results results[i] receives the cross sum of pinned and
+ * rows[i].
+ **********************************************************************/
+void getPinnedSumsOfMultipliedArrays(cf64 *pinned, cf64 * const *rows,
+                      csize_t numRows, csize_t size, f64 *results);
+
+
+/*******************************************************************//**
+ *  Pick the fastest getSumOfMultipliedArrays() implementation for
+ * arrays of a given length.  Lengths up to MAX_FIXED_KERNEL_LENGTH get a
+ * fully unrolled kernel from fixed-length-statistics.hpp; the returned
+ * function must only be called with that same size.
+ *
+ * @param[in] size Number of elements in each array.
+ **********************************************************************/
+sumOfMultipliedArraysFunction selectSumOfMultipliedArrays(csize_t size);
+
+
+/*******************************************************************//**
+ *  Pick the fastest getPinnedSumsOfMultipliedArrays() implementation
+ * for arrays of a given length.  The returned function must only be
+ * called with that same size.
+ *
+ * @param[in] size Number of elements in each array.
+ **********************************************************************/
+pinnedSumsOfMultipliedArraysFunction
+                      selectPinnedSumsOfMultipliedArrays(csize_t size);
+
+
+/*******************************************************************//**
+ *  Instruction set the reductions are currently using.
+ **********************************************************************/
+simdInstructionSet getStatisticsInstructionSet();
+
+
+/*******************************************************************//**
+ *  Switch the reductions to another instruction set, for testing or to
+ * reproduce results from another machine.  Not safe to call while
+ * other threads use the reductions.
+ *
+ * @param[in] level Instruction set to use.
+ *
+ * @return false, leaving the current choice, if this CPU lacks level.
+ **********************************************************************/
+bool setStatisticsInstructionSet(const simdInstructionSet level);
+
+
 /*******************************************************************//**
  *  Calculate correlation of two arrays, each of which having a mean of
  * 0.  This is using Spearman's Correlation Coefficient formula.
@@ -154,6 +245,58 @@ f64 getCenteredCorrelationBasic(cf64 aSumOfSquares, cf64 bSumOfSquares,
 void inplaceCenterMean(f64 *array, csize_t size);
 
 
+/*******************************************************************//**
+ *  Regularized incomplete beta function I_x(a, b), evaluated by
+ * continued fraction to about 1e-14 relative accuracy.
+ *
+ * @param[in] a First shape parameter, > 0.
+ * @param[in] b Second shape parameter, > 0.
+ * @param[in] x Point in [0, 1].
+ **********************************************************************/
+f64 regularizedIncompleteBeta(cf64 a, cf64 b, cf64 x);
+
+
+/*******************************************************************//**
+ *  As regularizedIncompleteBeta(a, b, x), for callers who know 1 - x
+ * more precisely than 1 minus the rounded x, such as 1 - r^2 and r^2.
+ **********************************************************************/
+f64 regularizedIncompleteBeta(cf64 a, cf64 b, cf64 x, cf64 oneMinusX);
+
+
+/*******************************************************************//**
+ *  Natural log of regularized incomplete beta function I_x(a, b),
+ * which stays finite where I_x(a, b) itself underflows.
+ **********************************************************************/
+f64 logRegularizedIncompleteBeta(cf64 a, cf64 b, cf64 x);
+
+
+/*******************************************************************//**
+ *  As logRegularizedIncompleteBeta(a, b, x), taking 1 - x separately.
+ **********************************************************************/
+f64 logRegularizedIncompleteBeta(cf64 a, cf64 b, cf64 x, cf64 oneMinusX);
+
+
+/*******************************************************************//**
+ *  Two sided p-value of a Student t statistic.
+ *
+ * @param[in] t The statistic.
+ * @param[in] degreesOfFreedom Degrees of freedom, > 0.  Need not be an
+ * integer, as for Welch's test.
+ **********************************************************************/
+f64 getStudentTPValue(cf64 t, cf64 degreesOfFreedom);
+
+
+/*******************************************************************//**
+ *  Upper tail p-value of an F statistic.
+ *
+ * @param[in] f The statistic.
+ * @param[in] numeratorDegreesOfFreedom Degrees of freedom, > 0.
+ * @param[in] denominatorDegreesOfFreedom Degrees of freedom, > 0.
+ **********************************************************************/
+f64 getFPValue(cf64 f, cf64 numeratorDegreesOfFreedom,
+                                    cf64 denominatorDegreesOfFreedom);
+
+
 //TODO: add doc
 
 ////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,229 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Products of the symmetric matrix held by an
+UpperDiagonalSquareMatrix with a vector or a block of vectors, for
+power iteration, Lanczos and the like without unpacking to dense.
+
+Each stored value a at (x, y), x > y, is read once and used for both
+halves: it adds a * in[x] to out[y] and a * in[y] to out[x].  So a
+product reads the packed triangle once, half what a dense product
+reads, and as these products are bound by memory bandwidth that is
+about half the time.
+
+The triangle is shared between the workers of autoThreadLauncher() as
+in upper-diagonal-square-matrix-operations.hpp.  Each worker adds into
+its own buffer, from its first row to the end, and a second parallel
+pass sums the buffers into out; this takes roughly one output's worth
+of extra memory per worker.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <short-primatives.h>
+#include <simple-thread-dispatch.hpp>
+#include <upper-diagonal-square-matrix.hpp>
+#include <upper-diagonal-square-matrix-operations.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//STRUCT DEFINITIONS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * One worker's share of a product: out[firstRow * numVectors] onward.
+ **********************************************************************/
+struct symmetricProductPartial{
+  size_t firstRow;
+  std::vector<f64> values;
+};
+
+
+struct symmetricProductSumStruct{
+  std::vector<symmetricProductPartial> *partials;
+  size_t numRows;
+  size_t numVectors;
+  f64 *out;
+};
+
+typedef struct symmetricProductSumStruct SPSS;
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DECLARATIONS////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief out = A in, A being the symmetric matrix whose upper triangle
+ * is stored in matrix.
+ *
+ * @param[in] in getSideLength() values.
+ *
+ * @param[out] out getSideLength() values.  Must not overlap in.
+ **********************************************************************/
+template<typename T, typename Layout> void multiplySymmetricMatrixVector(
+        UpperDiagonalSquareMatrix<T, Layout> &matrix, cf64 *in, f64 *out);
+
+
+/*******************************************************************//**
+ * \brief out = A in for a block of numVectors vectors at once, reading
+ * the matrix once for all of them.
+ *
+ * @param[in] in getSideLength() x numVectors values, row major, so
+ * vector v is in[i * numVectors + v].
+ *
+ * @param[out] out Same shape as in.  Must not overlap in.
+ **********************************************************************/
+template<typename T, typename Layout> void multiplySymmetricMatrixBlock(
+        UpperDiagonalSquareMatrix<T, Layout> &matrix, cf64 *in,
+                                      csize_t numVectors, f64 *out);
+
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Sums the workers' buffers over a share of out.
+inline void *symmetricProductSumHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  SPSS *args = (SPSS*) arg->specifics;
+  std::vector<symmetricProductPartial> &partials = *args->partials;
+  csize_t k = args->numVectors;
+  csize_t minimum = (args->numRows * numerator) / denominator;
+  csize_t maximum = (args->numRows * (numerator+1)) / denominator;
+
+  for(size_t i = minimum * k; i < maximum * k; i++) args->out[i] = 0;
+
+  for(size_t t = 0; t < partials.size(); t++){
+    if(partials[t].values.empty()) continue;
+    csize_t first = partials[t].firstRow;
+    csize_t from = minimum > first ? minimum : first;
+    cf64 *values = partials[t].values.data();
+    for(size_t i = from * k; i < maximum * k; i++)
+      args->out[i] += values[i - first * k];
+  }
+
+  return NULL;
+}
+
+
+inline void sumSymmetricProductPartials(
+        std::vector<symmetricProductPartial> &partials, csize_t numRows,
+                                        csize_t numVectors, f64 *out){
+  SPSS instructions = {&partials, numRows, numVectors, out};
+  autoThreadLauncher(symmetricProductSumHelper, (void*) &instructions);
+}
+
+
+template<typename T, typename Layout> void multiplySymmetricMatrixVector(
+        UpperDiagonalSquareMatrix<T, Layout> &matrix, cf64 *in, f64 *out){
+  csize_t n = matrix.getSideLength();
+  std::vector<symmetricProductPartial> partials(autoThreadCount());
+
+  //Runs never cross a row, and a worker's first run is its lowest row.
+  auto visit = [n, in, &partials](csize_t numerator, csize_t x,
+                            csize_t y, T *values, csize_t count){
+    symmetricProductPartial &partial = partials[numerator];
+    if(partial.values.empty()){
+      partial.firstRow = y;
+      partial.values.assign(n - y, 0);
+    }
+    //Entry i of the buffer is out[firstRow + i].
+    f64 *acc = partial.values.data();
+    csize_t base = partial.firstRow;
+
+    cf64 inY = in[y];
+    size_t i = 0;
+    f64 rowSum = 0;
+    if(x == y){
+      rowSum = values[0] * inY;
+      i = 1;
+    }
+    for(; i < count; i++){
+      cf64 a = values[i];
+      rowSum += a * in[x + i];
+      acc[x + i - base] += a * inY;
+    }
+    acc[y - base] += rowSum;
+  };
+  runMatrixOperation(matrix, visit, false, partials.size());
+
+  sumSymmetricProductPartials(partials, n, 1, out);
+}
+
+
+template<typename T, typename Layout> void multiplySymmetricMatrixBlock(
+        UpperDiagonalSquareMatrix<T, Layout> &matrix, cf64 *in,
+                                      csize_t numVectors, f64 *out){
+  csize_t n = matrix.getSideLength();
+  csize_t k = numVectors;
+  std::vector<symmetricProductPartial> partials(autoThreadCount());
+  std::vector<std::vector<f64> > rowSums(partials.size(),
+                                                  std::vector<f64>(k));
+
+  auto visit = [n, k, in, &partials, &rowSums](csize_t numerator,
+                  csize_t x, csize_t y, T *values, csize_t count){
+    symmetricProductPartial &partial = partials[numerator];
+    if(partial.values.empty()){
+      partial.firstRow = y;
+      partial.values.assign((n - y) * k, 0);
+    }
+    f64 *acc = partial.values.data();
+    csize_t base = partial.firstRow;
+    f64 *rowSum = rowSums[numerator].data();
+    cf64 *inY = in + y * k;
+
+    for(size_t v = 0; v < k; v++) rowSum[v] = 0;
+    size_t i = 0;
+    if(x == y){
+      for(size_t v = 0; v < k; v++) rowSum[v] = values[0] * inY[v];
+      i = 1;
+    }
+    for(; i < count; i++){
+      cf64 a = values[i];
+      cf64 *inX = in + (x + i) * k;
+      f64 *accX = acc + (x + i - base) * k;
+      for(size_t v = 0; v < k; v++){
+        rowSum[v] += a * inX[v];
+        accX[v] += a * inY[v];
+      }
+    }
+    for(size_t v = 0; v < k; v++) acc[(y - base) * k + v] += rowSum[v];
+  };
+  runMatrixOperation(matrix, visit, false, partials.size());
+
+  sumSymmetricProductPartials(partials, n, k, out);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,130 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Run a set of tasks with dependencies between them on the
+process wide thread pool.
+
+A multi stage job split into chunk sized tasks, where each chunk of one
+stage depends only on the chunks of earlier stages it reads, lets later
+stages start on some chunks while earlier stages finish others, rather
+than every core waiting at a barrier for the slowest share of a stage.
+
+A task becomes ready once every task it depends on has finished, and is
+then queued on getThreadPool().  The thread calling run() works through
+queued tasks too, so a graph also runs with no pool workers at all.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <short-primatives.h>
+#include <thread-pool.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+class TaskGraph{
+  private:
+  struct taskNode{
+    std::function<void()> work;
+    std::vector<size_t> successors;
+    size_t numPredecessors;
+    std::atomic<size_t> waitingOn;
+    TaskGraph *graph;
+    //Filled in when profiling.
+    f64 busySeconds;
+    size_t threadSlot;
+  };
+
+  //A deque so nodes stay put as tasks are added.
+  std::deque<taskNode> nodes;
+  ThreadPool *pool;
+  threadPoolGroup *group;
+  bool profiling;
+  const char *region;
+
+  static void *runTaskNode(void *protoArgs);
+  bool isAcyclic() const;
+  void recordRun(cf64 wallSeconds);
+
+  public:
+
+/***********************************************************************
+ * An empty graph.
+ **********************************************************************/
+  TaskGraph();
+
+
+  TaskGraph(const TaskGraph&) = delete;
+  TaskGraph& operator=(const TaskGraph&) = delete;
+
+
+/*******************************************************************//**
+ * \brief Add a task.
+ *
+ * @param[in] work Run once per run(), possibly concurrently with any
+ * task it does not depend on, directly or indirectly.
+ *
+ * @return The task's number, counting from 0 in order of addition.
+ **********************************************************************/
+  size_t addTask(std::function<void()> work);
+
+
+/***********************************************************************
+ * Make task after wait for task before to finish.
+ **********************************************************************/
+  void addDependency(csize_t before, csize_t after);
+
+
+/*******************************************************************//**
+ * \brief Run every task once, respecting dependencies, and return when
+ * all have finished.  May be called again to run the graph again.
+ * Every task is run even if parallelCancelled(); a task which should
+ * stop early checks for itself.
+ * When profiling, recorded as one launch of the current region with a
+ * share per thread that ran tasks, counting tasks as items.
+ *
+ * @return false, running nothing, if the dependencies form a cycle.
+ **********************************************************************/
+  bool run();
+
+
+/***********************************************************************
+ * Number of tasks added.
+ **********************************************************************/
+  size_t numberOfTasks() const;
+};
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,165 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief A process wide pool of parked worker threads behind
+autoThreadLauncher(), so that launching a parallel job costs a queue
+push and a wake up rather than creating and joining threads.
+
+Jobs are plain function and argument pairs, as with pthread_create(),
+collected into a threadPoolGroup so a caller can wait on just its own.
+A thread waiting on a group runs that group's queued jobs until it is
+done, so launching from inside a job cannot deadlock the pool: every
+job a waiter needs is either queued, and so run by the waiter, or
+already running elsewhere.  Jobs of other groups are left to the
+workers, so how long a wait takes depends only on its own jobs.  A job runs
+under the ParallelControl, if any, of the thread that submitted it.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <parallel-control.hpp>
+#include <short-primatives.h>
+#include <simple-thread-dispatch.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//STRUCT DEFINITIONS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Jobs submitted together, waited on together.
+ **********************************************************************/
+struct threadPoolGroup{
+  std::atomic<size_t> pending{0};
+};
+
+
+struct threadPoolTask{
+  void* (*func)(void*);
+  void *arg;
+  threadPoolGroup *group;
+  ParallelControl *control;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+class ThreadPool{
+  private:
+  std::vector<std::thread> workers;
+  std::deque<threadPoolTask> queue;
+  std::mutex queueLock;
+  std::condition_variable changed;
+  bool stopping;
+
+  void workerLoop();
+  void runTask(threadPoolTask task);
+
+  public:
+
+/*******************************************************************//**
+ * \brief Start numWorkers parked workers.  With none, every job is run
+ * by the thread which waits on it.
+ *
+ * @param[in] pinTo If not empty, worker i is pinned to CPU
+ * pinTo[(i+1) % pinTo.size()], leaving pinTo[0] to the calling thread.
+ **********************************************************************/
+  explicit ThreadPool(csize_t numWorkers,
+                      const std::vector<size_t> &pinTo = {});
+
+
+/***********************************************************************
+ * Finish queued jobs, then stop and join the workers.
+ **********************************************************************/
+  ~ThreadPool();
+
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+
+/***********************************************************************
+ * Number of threads started by the pool.
+ **********************************************************************/
+  size_t numberOfWorkers() const;
+
+
+/*******************************************************************//**
+ * \brief Queue func(arg) as part of group.
+ *
+ * @param[in] group Counts the job until it has run.  Must outlive it.
+ **********************************************************************/
+  void submit(void* (*func)(void*), void *arg, threadPoolGroup *group);
+
+
+/***********************************************************************
+ * Return once every job in group has run, running queued jobs of
+ * group in the meantime.
+ **********************************************************************/
+  void wait(threadPoolGroup *group);
+
+
+/*******************************************************************//**
+ * \brief Run func once for each of count loads, the calling thread
+ * taking the first, and return when all are done.
+ **********************************************************************/
+  void run(void* (*func)(void*), struct multithreadLoad *loads,
+                                                      csize_t count);
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief The process wide pool, started on first use with
+ * autoThreadCount() - 1 workers; the caller of run() is the last.
+ * Workers are pinned if threadsArePinned().
+ **********************************************************************/
+ThreadPool& getThreadPool();
+
+
+/***********************************************************************
+ * Stop the process wide pool so the next getThreadPool() starts one
+ * under the current thread policy.  No job may be running.
+ **********************************************************************/
+void restartThreadPool();
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
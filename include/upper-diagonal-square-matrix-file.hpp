@@ -0,0 +1,389 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Save an UpperDiagonalSquareMatrix to disk, and load it back or
+map it read only so its values are usable without reading them first.
+
+File layout, all integers in the writer's byte order:
+  header (4096 bytes, see matrixFileHeader in the source), giving the
+    format version, element type and size, side length, layout and
+    tile size, element count and data checksum
+  numberOfElements() values exactly as held in memory by the layout
+
+The data starts on a page boundary, so a mapping of the file can be
+used in place.  The checksum hashes the data in 1 MiB blocks, each
+with four interleaved 64 bit multiply-rotate lanes, and folds the
+block hashes in order; blocks are hashed in parallel.  Checking it
+means reading the whole file, so mapping skips it unless asked.
+
+Files are written to path.tmp and renamed into place, so a reader never
+sees a half written file.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include <short-primatives.h>
+#include <upper-diagonal-square-matrix.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//ENUMS AND STRUCTS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Element types a matrix file may hold.  The values are part of the
+ * format and must not change.
+ **********************************************************************/
+enum matrixElementType{
+  MATRIX_ELEMENT_F64 = 1,
+  MATRIX_ELEMENT_F32 = 2,
+  MATRIX_ELEMENT_S8 = 3,
+  MATRIX_ELEMENT_S16 = 4,
+  MATRIX_ELEMENT_S32 = 5,
+  MATRIX_ELEMENT_S64 = 6,
+  MATRIX_ELEMENT_U8 = 7,
+  MATRIX_ELEMENT_U16 = 8,
+  MATRIX_ELEMENT_U32 = 9,
+  MATRIX_ELEMENT_U64 = 10
+};
+
+
+/***********************************************************************
+ * Storage layouts a matrix file may hold.  Part of the format.
+ **********************************************************************/
+enum matrixLayoutType{
+  MATRIX_LAYOUT_ROW_PACKED = 1,
+  MATRIX_LAYOUT_TILED = 2
+};
+
+
+/***********************************************************************
+ * What a matrix file holds, as recorded in its header.
+ **********************************************************************/
+struct matrixFileDescription{
+  u32 elementType;
+  u32 elementSize;
+  u64 sideLength;
+  u32 layout;
+  u32 tileSize;
+  u64 numElements;
+};
+
+
+template<typename T> struct matrixElementTypeOf;
+template<> struct matrixElementTypeOf<f64>{
+  static cu32 value = MATRIX_ELEMENT_F64;
+};
+template<> struct matrixElementTypeOf<f32>{
+  static cu32 value = MATRIX_ELEMENT_F32;
+};
+template<> struct matrixElementTypeOf<s8>{
+  static cu32 value = MATRIX_ELEMENT_S8;
+};
+template<> struct matrixElementTypeOf<s16>{
+  static cu32 value = MATRIX_ELEMENT_S16;
+};
+template<> struct matrixElementTypeOf<s32>{
+  static cu32 value = MATRIX_ELEMENT_S32;
+};
+template<> struct matrixElementTypeOf<s64>{
+  static cu32 value = MATRIX_ELEMENT_S64;
+};
+template<> struct matrixElementTypeOf<u8>{
+  static cu32 value = MATRIX_ELEMENT_U8;
+};
+template<> struct matrixElementTypeOf<u16>{
+  static cu32 value = MATRIX_ELEMENT_U16;
+};
+template<> struct matrixElementTypeOf<u32>{
+  static cu32 value = MATRIX_ELEMENT_U32;
+};
+template<> struct matrixElementTypeOf<u64>{
+  static cu32 value = MATRIX_ELEMENT_U64;
+};
+
+
+template<typename Layout> struct matrixLayoutOf;
+template<> struct matrixLayoutOf<RowPackedLayout>{
+  static cu32 value = MATRIX_LAYOUT_ROW_PACKED;
+  static cu32 tileSize = 0;
+};
+template<size_t B> struct matrixLayoutOf<TiledLayout<B> >{
+  static cu32 value = MATRIX_LAYOUT_TILED;
+  static cu32 tileSize = B;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS DEFINITION//////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * A matrix file mapped read only.  Writing through getMatrix() faults.
+ * The mapping, and the matrix, last until close() or destruction.
+ **********************************************************************/
+template<typename T, typename Layout = RowPackedLayout>
+                              class MappedUpperDiagonalSquareMatrix{
+  private:
+  void *mapping;
+  size_t mappingSize;
+  UpperDiagonalSquareMatrix<T, Layout> *matrix;
+
+  public:
+
+/***********************************************************************
+ *
+ **********************************************************************/
+  MappedUpperDiagonalSquareMatrix();
+
+
+/***********************************************************************
+ *
+ **********************************************************************/
+  ~MappedUpperDiagonalSquareMatrix();
+
+
+  MappedUpperDiagonalSquareMatrix(
+                      const MappedUpperDiagonalSquareMatrix&) = delete;
+  MappedUpperDiagonalSquareMatrix& operator=(
+                      const MappedUpperDiagonalSquareMatrix&) = delete;
+
+
+/*******************************************************************//**
+ * \brief Map a matrix file.
+ *
+ * @param[in] verify Read the whole file to check its checksum first.
+ *
+ * @return false if the file is missing, damaged, or holds a different
+ * element type or layout.
+ **********************************************************************/
+  bool open(const std::string &path, const bool verify = false);
+
+
+/***********************************************************************
+ * Unmap the file.
+ **********************************************************************/
+  void close();
+
+
+/***********************************************************************
+ * The mapped matrix.  Only valid after a successful open().
+ **********************************************************************/
+  UpperDiagonalSquareMatrix<T, Layout>& getMatrix();
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DECLARATIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Checksum of matrix data as stored in the file header.
+ **********************************************************************/
+u64 checksumMatrixData(const void *data, csize_t size);
+
+
+/*******************************************************************//**
+ * \brief Write a matrix file from raw storage.
+ *
+ * @return false on I/O failure, in which case path is left untouched.
+ **********************************************************************/
+bool writeMatrixFile(const std::string &path,
+          const matrixFileDescription &description, const void *data);
+
+
+/*******************************************************************//**
+ * \brief Read a matrix file's header.
+ *
+ * @return false if the file is missing, not a matrix file of this
+ * version and byte order, or too short for the data its header claims.
+ **********************************************************************/
+bool readMatrixFileDescription(const std::string &path,
+                                    matrixFileDescription &description);
+
+
+/***********************************************************************
+ * Whether two descriptions agree in every field.
+ **********************************************************************/
+bool matrixDescriptionsMatch(const matrixFileDescription &found,
+                              const matrixFileDescription &expected);
+
+
+/*******************************************************************//**
+ * \brief Read a matrix file's data into memory, checking it matches
+ * expected and its checksum.
+ *
+ * @param[out] data Room for expected.numElements elements.
+ **********************************************************************/
+bool readMatrixFile(const std::string &path,
+                const matrixFileDescription &expected, void *data);
+
+
+/*******************************************************************//**
+ * \brief Map a matrix file read only, checking it matches expected.
+ *
+ * @param[out] mappingSize Length of the mapping, for munmap().
+ *
+ * @return The mapping, whose data starts at
+ * matrixFileDataOffset() bytes in, or NULL on failure.
+ **********************************************************************/
+void *mapMatrixFile(const std::string &path,
+                const matrixFileDescription &expected, const bool verify,
+                                                  size_t &mappingSize);
+
+
+/***********************************************************************
+ * Undo mapMatrixFile().  Does nothing for a NULL mapping.
+ **********************************************************************/
+void unmapMatrixFile(void *mapping, csize_t mappingSize);
+
+
+/***********************************************************************
+ * Byte offset of the data in a matrix file.
+ **********************************************************************/
+size_t matrixFileDataOffset();
+
+
+/*******************************************************************//**
+ * \brief Save a matrix.
+ *
+ * @return false on I/O failure.
+ **********************************************************************/
+template<typename T, typename Layout> bool saveUpperDiagonalSquareMatrix(
+  const std::string &path, UpperDiagonalSquareMatrix<T, Layout> &matrix);
+
+
+/*******************************************************************//**
+ * \brief Load a matrix into memory, checking its checksum.
+ *
+ * @return A new matrix for the caller to delete, or NULL if the file
+ * is missing, damaged, or holds a different element type or layout.
+ **********************************************************************/
+template<typename T, typename Layout = RowPackedLayout>
+            UpperDiagonalSquareMatrix<T, Layout>*
+                  loadUpperDiagonalSquareMatrix(const std::string &path);
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DEFINITIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Header fields for a matrix of this type, layout and size.
+template<typename T, typename Layout> matrixFileDescription
+          describeMatrix(UpperDiagonalSquareMatrix<T, Layout> &matrix){
+  matrixFileDescription tr;
+  tr.elementType = matrixElementTypeOf<T>::value;
+  tr.elementSize = sizeof(T);
+  tr.sideLength = matrix.getSideLength();
+  tr.layout = matrixLayoutOf<Layout>::value;
+  tr.tileSize = matrixLayoutOf<Layout>::tileSize;
+  tr.numElements = matrix.numberOfElements();
+  return tr;
+}
+
+
+template<typename T, typename Layout> bool saveUpperDiagonalSquareMatrix(
+  const std::string &path, UpperDiagonalSquareMatrix<T, Layout> &matrix){
+  return writeMatrixFile(path, describeMatrix(matrix), matrix.data());
+}
+
+
+template<typename T, typename Layout> UpperDiagonalSquareMatrix<T, Layout>*
+                  loadUpperDiagonalSquareMatrix(const std::string &path){
+  matrixFileDescription found;
+  if(!readMatrixFileDescription(path, found)) return NULL;
+
+  //Check the header against an empty matrix of the found size before
+  //allocating, so a wrong type or layout or a damaged size costs nothing.
+  UpperDiagonalSquareMatrix<T, Layout> shape(found.sideLength, NULL);
+  if(!matrixDescriptionsMatch(found, describeMatrix(shape))) return NULL;
+
+  UpperDiagonalSquareMatrix<T, Layout> *tr =
+                  new UpperDiagonalSquareMatrix<T, Layout>(found.sideLength);
+  if(!readMatrixFile(path, describeMatrix(*tr), tr->data())){
+    delete tr;
+    return NULL;
+  }
+
+  return tr;
+}
+
+
+template<typename T, typename Layout> MappedUpperDiagonalSquareMatrix<T,
+                            Layout>::MappedUpperDiagonalSquareMatrix(){
+  mapping = NULL;
+  mappingSize = 0;
+  matrix = NULL;
+}
+
+
+template<typename T, typename Layout> MappedUpperDiagonalSquareMatrix<T,
+                            Layout>::~MappedUpperDiagonalSquareMatrix(){
+  close();
+}
+
+
+template<typename T, typename Layout> bool MappedUpperDiagonalSquareMatrix<T,
+                Layout>::open(const std::string &path, const bool verify){
+  close();
+
+  matrixFileDescription found;
+  if(!readMatrixFileDescription(path, found)) return false;
+
+  //Describe what we expect from an empty matrix of the found size; it
+  //owns nothing worth freeing.
+  UpperDiagonalSquareMatrix<T, Layout> shape(found.sideLength, NULL);
+  mapping = mapMatrixFile(path, describeMatrix(shape), verify,
+                                                          mappingSize);
+  if(NULL == mapping) return false;
+
+  matrix = new UpperDiagonalSquareMatrix<T, Layout>(found.sideLength,
+                        (T*) ((u8*) mapping + matrixFileDataOffset()));
+  return true;
+}
+
+
+template<typename T, typename Layout> void MappedUpperDiagonalSquareMatrix<T,
+                                                      Layout>::close(){
+  delete matrix;
+  matrix = NULL;
+  unmapMatrixFile(mapping, mappingSize);
+  mapping = NULL;
+  mappingSize = 0;
+}
+
+
+template<typename T, typename Layout> UpperDiagonalSquareMatrix<T, Layout>&
+            MappedUpperDiagonalSquareMatrix<T, Layout>::getMatrix(){
+  return *matrix;
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
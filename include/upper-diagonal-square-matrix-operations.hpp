@@ -0,0 +1,264 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+/*******************************************************************//**
+@file
+@brief Parallel bulk operations over every stored value of an
+UpperDiagonalSquareMatrix.
+
+Each worker of autoThreadLauncher() takes an equal share of the
+triangle in row order and visits it as runs of values contiguous in
+storage, so the per value work is a plain loop over an array which the
+compiler can vectorize once the operation is inlined.  Row packed
+matrices give one run per row; tiled ones one per tile crossed.
+Padding in tiled layouts is never visited.
+
+Operations given to reduceUpperDiagonalSquareMatrix() must be
+associative and commutative, as each worker reduces its own share.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <short-primatives.h>
+#include <simple-thread-dispatch.hpp>
+#include <upper-diagonal-square-matrix.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//STRUCT DEFINITIONS////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * One value of a matrix and where it was found, x >= y.
+ **********************************************************************/
+template<typename T> struct matrixEntry{
+  size_t x;
+  size_t y;
+  T value;
+};
+
+
+template<typename T, typename Layout, typename Visit>
+                                      struct matrixOperationStruct{
+  UpperDiagonalSquareMatrix<T, Layout> *matrix;
+  Visit *visit;
+  bool skipDiagonal;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DECLARATIONS////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Replace every stored value v, diagonal included, with op(v).
+ **********************************************************************/
+template<typename T, typename Layout, typename Op>
+  void transformUpperDiagonalSquareMatrix(
+                      UpperDiagonalSquareMatrix<T, Layout> &matrix, Op op);
+
+
+/*******************************************************************//**
+ * \brief Combine every stored value with op.
+ *
+ * @param[in] identity Value with op(identity, v) == v; each worker
+ * starts from it.
+ *
+ * @param[in] op Associative, commutative R op(R, R).
+ *
+ * @param[in] skipDiagonal Leave out the values at (i, i).
+ **********************************************************************/
+template<typename R, typename T, typename Layout, typename Op>
+  R reduceUpperDiagonalSquareMatrix(
+          UpperDiagonalSquareMatrix<T, Layout> &matrix, const R identity,
+                                Op op, const bool skipDiagonal = false);
+
+
+/*******************************************************************//**
+ * \brief Number of stored values v with pred(v).
+ *
+ * @param[in] skipDiagonal Leave out the values at (i, i).
+ **********************************************************************/
+template<typename T, typename Layout, typename Pred>
+  size_t countIfUpperDiagonalSquareMatrix(
+          UpperDiagonalSquareMatrix<T, Layout> &matrix, Pred pred,
+                                        const bool skipDiagonal = false);
+
+
+/*******************************************************************//**
+ * \brief Every stored value v with pred(v), and its coordinates, in row
+ * order.
+ *
+ * @param[in] skipDiagonal Leave out the values at (i, i).
+ **********************************************************************/
+template<typename T, typename Layout, typename Pred>
+  std::vector<matrixEntry<T> > extractIfUpperDiagonalSquareMatrix(
+          UpperDiagonalSquareMatrix<T, Layout> &matrix, Pred pred,
+                                        const bool skipDiagonal = false);
+
+
+////////////////////////////////////////////////////////////////////////
+//TEMPLATE FUNCTION DEFINITIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Worker for every operation here.  Calls
+//visit(numerator, x, y, values, count) for each run of its share,
+//values[i] being the value at (x+i, y).
+template<typename T, typename Layout, typename Visit>
+                              void *matrixOperationHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  matrixOperationStruct<T, Layout, Visit> *args =
+                  (matrixOperationStruct<T, Layout, Visit>*) arg->specifics;
+  UpperDiagonalSquareMatrix<T, Layout> &matrix = *args->matrix;
+  Visit &visit = *args->visit;
+
+  //Row order numbering is the row packed storage order, whatever the
+  //layout, so its inverse locates the start of this share.
+  RowPackedLayout rowOrder;
+  rowOrder.setSideLength(matrix.getSideLength());
+  csize_t n = matrix.getSideLength();
+  csize_t total = rowOrder.numberOfElements();
+  csize_t minimum = (total * numerator) / denominator;
+  csize_t maximum = (total * (numerator+1)) / denominator;
+  if(minimum >= maximum) return NULL;
+
+  std::pair<size_t, size_t> start = rowOrder.position(minimum);
+  size_t remaining = maximum - minimum;
+
+  for(size_t y = start.second, x = start.first; remaining > 0;
+                                                            y++, x = y){
+    csize_t rowEnd = n < x + remaining ? n : x + remaining;
+    remaining -= rowEnd - x;
+
+    if(x == y && args->skipDiagonal) x++;
+    while(x < rowEnd){
+      csize_t run = matrix.getRunLength(x, y);
+      csize_t count = run < rowEnd - x ? run : rowEnd - x;
+      visit(numerator, x, y, matrix.getReferenceForIndex(x, y), count);
+      x += count;
+    }
+  }
+
+  return NULL;
+}
+
+
+//Splits between numThreads workers, so numerator < numThreads even if
+//the thread count changes while a per worker array is being sized.
+template<typename T, typename Layout, typename Visit>
+  void runMatrixOperation(UpperDiagonalSquareMatrix<T, Layout> &matrix,
+          Visit &visit, const bool skipDiagonal, csize_t numThreads){
+  matrixOperationStruct<T, Layout, Visit> instructions = {
+      &matrix,
+      &visit,
+      skipDiagonal
+    };
+
+  autoThreadLauncher(matrixOperationHelper<T, Layout, Visit>,
+                                    (void*) &instructions, numThreads);
+}
+
+
+template<typename T, typename Layout, typename Op>
+  void transformUpperDiagonalSquareMatrix(
+                      UpperDiagonalSquareMatrix<T, Layout> &matrix, Op op){
+  auto visit = [&op](csize_t, csize_t, csize_t, T *values, csize_t count){
+    for(size_t i = 0; i < count; i++) values[i] = op(values[i]);
+  };
+  runMatrixOperation(matrix, visit, false, autoThreadCount());
+}
+
+
+template<typename R, typename T, typename Layout, typename Op>
+  R reduceUpperDiagonalSquareMatrix(
+          UpperDiagonalSquareMatrix<T, Layout> &matrix, const R identity,
+                                      Op op, const bool skipDiagonal){
+  std::vector<R> partials(autoThreadCount(), identity);
+  auto visit = [&op, &partials](csize_t numerator, csize_t, csize_t,
+                                          T *values, csize_t count){
+    R acc = partials[numerator];
+    for(size_t i = 0; i < count; i++) acc = op(acc, (R) values[i]);
+    partials[numerator] = acc;
+  };
+  runMatrixOperation(matrix, visit, skipDiagonal, partials.size());
+
+  R tr = identity;
+  for(size_t i = 0; i < partials.size(); i++) tr = op(tr, partials[i]);
+  return tr;
+}
+
+
+template<typename T, typename Layout, typename Pred>
+  size_t countIfUpperDiagonalSquareMatrix(
+          UpperDiagonalSquareMatrix<T, Layout> &matrix, Pred pred,
+                                              const bool skipDiagonal){
+  std::vector<size_t> partials(autoThreadCount(), 0);
+  auto visit = [&pred, &partials](csize_t numerator, csize_t, csize_t,
+                                          T *values, csize_t count){
+    size_t acc = 0;
+    for(size_t i = 0; i < count; i++) acc += pred(values[i]) ? 1 : 0;
+    partials[numerator] += acc;
+  };
+  runMatrixOperation(matrix, visit, skipDiagonal, partials.size());
+
+  size_t tr = 0;
+  for(size_t i = 0; i < partials.size(); i++) tr += partials[i];
+  return tr;
+}
+
+
+//Shares are consecutive in row order, so joining the workers' finds in
+//worker order keeps the result in row order.
+template<typename T, typename Layout, typename Pred>
+  std::vector<matrixEntry<T> > extractIfUpperDiagonalSquareMatrix(
+          UpperDiagonalSquareMatrix<T, Layout> &matrix, Pred pred,
+                                              const bool skipDiagonal){
+  std::vector<std::vector<matrixEntry<T> > > partials(autoThreadCount());
+  auto visit = [&pred, &partials](csize_t numerator, csize_t x, csize_t y,
+                                          T *values, csize_t count){
+    std::vector<matrixEntry<T> > &found = partials[numerator];
+    for(size_t i = 0; i < count; i++)
+      if(pred(values[i])) found.push_back({x + i, y, values[i]});
+  };
+  runMatrixOperation(matrix, visit, skipDiagonal, partials.size());
+
+  size_t total = 0;
+  for(size_t i = 0; i < partials.size(); i++) total += partials[i].size();
+
+  std::vector<matrixEntry<T> > tr;
+  tr.reserve(total);
+  for(size_t i = 0; i < partials.size(); i++)
+    tr.insert(tr.end(), partials[i].begin(), partials[i].end());
+  return tr;
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,16 @@
 @file
 @brief A matrix representation which saves space when a user only needs an upper
 diagonal matrix.
+
+Where the triangle lives in memory is set by a layout policy.
+RowPackedLayout, the default, stores each row of the triangle after the
+last, so rows are contiguous but walking a column strides across the
+whole allocation.  TiledLayout<B> stores the triangle as B x B tiles,
+row major within a tile and tiles ordered row by row along the upper
+triangle of tiles, so both rows and columns are walked a tile at a time
+and a kernel producing a tile can write it contiguously.  Diagonal
+tiles are stored whole, so a tiled matrix allocates somewhat more than
+numberOfElements() reports for the row packed one.
 ***********************************************************************/
 
 #pragma once
@@ -30,23 +40,238 @@ diagonal matrix.
 ////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <memory>
 #include <string.h>
 #include <tgmath.h>
 #include <utility>
 
+#include <large-allocation.hpp>
 #include <short-primatives.h>
 
+////////////////////////////////////////////////////////////////////////
+//LAYOUT POLICIES///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Each row of the triangle, from the diagonal rightward, follows the
+ * last.  Offsets are only asked for with x >= y.
+ **********************************************************************/
+class RowPackedLayout{
+  private:
+  size_t n;
+
+  public:
+  static constexpr const bool CONTIGUOUS_ROWS = true;
+
+  void setSideLength(csize_t sideLength){ n = sideLength; }
+
+  size_t numberOfElements() const{ return (n*n)-(n * (n-1)) / 2; }
+
+  size_t offset(csize_t x, csize_t y) const{
+    return (y*n)+x-(y*(y-1)/2)-y;
+  }
+
+  //Offset of (x+1, y) and (x, y+1) given the offset of (x, y).
+  size_t nextInRow(csize_t w, csize_t, csize_t) const{ return w + 1; }
+
+  //How many values from column x rightward are contiguous.
+  size_t runInRow(csize_t x) const{ return n - x; }
+
+  size_t nextInColumn(csize_t w, csize_t, csize_t y) const{
+    return w + n - y - 1;
+  }
+
+  std::pair<size_t, size_t> position(csize_t w) const{
+    csize_t wPrime = numberOfElements() - w - 1;
+    csize_t y = n - floorl(0.5 + sqrtl(1L+8*wPrime)/2);
+    csize_t x = w - ((n*y) - (y * (y+1))/2);
+    return std::pair<size_t, size_t>(x, y);
+  }
+};
+
+
+/***********************************************************************
+ * B x B tiles, row major within a tile, tiles numbered row by row along
+ * the upper triangle of tiles.  Tile (tx, ty) starts at
+ * offset(tx*B, ty*B) and holds B*B contiguous values; parts of it past
+ * the side length or below the diagonal are padding.
+ **********************************************************************/
+template<size_t B> class TiledLayout{
+  static_assert(B > 0, "TiledLayout needs a non-zero tile size");
+
+  private:
+  size_t n;
+  size_t tilesPerSide;
+
+  size_t tileNumber(csize_t tx, csize_t ty) const{
+    return (ty*tilesPerSide)+tx-(ty*(ty-1)/2)-ty;
+  }
+
+  public:
+  static constexpr const bool CONTIGUOUS_ROWS = false;
+  static constexpr const size_t TILE_SIZE = B;
+
+  void setSideLength(csize_t sideLength){
+    n = sideLength;
+    tilesPerSide = (n + B-1) / B;
+  }
+
+  size_t numberOfElements() const{
+    return (tilesPerSide * (tilesPerSide+1)) / 2 * B * B;
+  }
+
+  size_t offset(csize_t x, csize_t y) const{
+    return tileNumber(x / B, y / B) * B * B + (y % B) * B + (x % B);
+  }
+
+  //Tiles along a row of tiles are adjacent, so only crossing into the
+  //next row of tiles needs the full calculation.
+  size_t nextInRow(csize_t w, csize_t x, csize_t) const{
+    return (x+1) % B ? w + 1 : w + B*B - B + 1;
+  }
+
+  size_t nextInColumn(csize_t w, csize_t x, csize_t y) const{
+    return (y+1) % B ? w + B : offset(x, y+1);
+  }
+
+  size_t runInRow(csize_t x) const{
+    return B - x % B < n - x ? B - x % B : n - x;
+  }
+
+  std::pair<size_t, size_t> position(csize_t w) const{
+    csize_t tile = w / (B*B);
+    csize_t tiles = (tilesPerSide * (tilesPerSide+1)) / 2;
+    csize_t tPrime = tiles - tile - 1;
+    csize_t ty = tilesPerSide - floorl(0.5 + sqrtl(1L+8*tPrime)/2);
+    csize_t tx = tile - ((tilesPerSide*ty) - (ty * (ty+1))/2);
+    csize_t x = tx * B + (w % B);
+    csize_t y = ty * B + (w % (B*B)) / B;
+    if(x >= n || y > x) return std::pair<size_t, size_t>(-1, -1);
+    return std::pair<size_t, size_t>(x, y);
+  }
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//ITERATOR DEFINITION///////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * Walks one row (x increasing from the diagonal) or one column (y
+ * increasing down to the diagonal) of the stored triangle.
+ **********************************************************************/
+template<typename T, typename Layout> class UpperDiagonalSquareMatrixIterator{
+  private:
+  T *base;
+  const Layout *layout;
+  size_t w;
+  size_t x;
+  size_t y;
+  bool alongRow;
+
+  public:
+  UpperDiagonalSquareMatrixIterator(T *base, const Layout *layout,
+                          csize_t x, csize_t y, const bool alongRow){
+    this->base = base;
+    this->layout = layout;
+    this->x = x;
+    this->y = y;
+    this->alongRow = alongRow;
+    w = layout->offset(x, y);
+  }
+
+  T& operator*() const{ return base[w]; }
+
+  UpperDiagonalSquareMatrixIterator& operator++(){
+    if(alongRow){
+      w = layout->nextInRow(w, x, y);
+      x++;
+    }else{
+      w = layout->nextInColumn(w, x, y);
+      y++;
+    }
+    return *this;
+  }
+
+  //Which column (along a row) or row (along a column) is next.
+  size_t index() const{ return alongRow ? x : y; }
+
+  bool operator==(const UpperDiagonalSquareMatrixIterator &other) const{
+    return x == other.x && y == other.y;
+  }
+
+  bool operator!=(const UpperDiagonalSquareMatrixIterator &other) const{
+    return !(*this == other);
+  }
+};
+
+
+/***********************************************************************
+ * Walks the stored triangle in row order, (y, y) through (n-1, y) then
+ * on to (y+1, y+1), keeping its coordinates and storage offset up to
+ * date as it goes rather than recomputing them from one another.
+ **********************************************************************/
+template<typename T, typename Layout> class UpperDiagonalSquareMatrixCursor{
+  private:
+  T *base;
+  const Layout *layout;
+  size_t n;
+  size_t cx;
+  size_t cy;
+  size_t cw;
+
+  public:
+  UpperDiagonalSquareMatrixCursor(T *base, const Layout *layout,
+                                  csize_t n, csize_t x, csize_t y){
+    this->base = base;
+    this->layout = layout;
+    this->n = n;
+    cx = x;
+    cy = y;
+    cw = layout->offset(x, y);
+  }
+
+  T& operator*() const{ return base[cw]; }
+
+  UpperDiagonalSquareMatrixCursor& operator++(){
+    if(cx + 1 < n){
+      cw = layout->nextInRow(cw, cx, cy);
+      cx++;
+    }else{
+      cy++;
+      cx = cy;
+      cw = layout->offset(cx, cy);
+    }
+    return *this;
+  }
+
+  size_t x() const{ return cx; }
+  size_t y() const{ return cy; }
+  size_t w() const{ return cw; }
+};
+
+
 ////////////////////////////////////////////////////////////////////////
 //CLASS DEFINITION//////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-template<typename T> class UpperDiagonalSquareMatrix{
+template<typename T, typename Layout = RowPackedLayout,
+          typename Allocator = largeAllocator<T> >
+                                        class UpperDiagonalSquareMatrix{
   private:
   T *oneDMatrix;
   size_t n;
+  Layout layout;
+  bool ownsStorage;
+  Allocator allocator;
+
+  void release();
 
   public:
 
+  typedef UpperDiagonalSquareMatrixIterator<T, Layout> iterator;
+  typedef UpperDiagonalSquareMatrixCursor<T, Layout> cursor;
+
 /***********************************************************************
  *
  **********************************************************************/
@@ -70,13 +295,38 @@ template<typename T> class UpperDiagonalSquareMatrix{
 
 
 /***********************************************************************
- *
+ * Allocate, but do not initialize, storage for a sideLength square.
+ * zeroData() initializes it in parallel.
  **********************************************************************/
-  UpperDiagonalSquareMatrix(size_t sideLength);
+  explicit UpperDiagonalSquareMatrix(size_t sideLength,
+                                    const Allocator &allocator = Allocator());
 
 
 /***********************************************************************
- *
+ * Wrap existing storage of numberOfElements() values laid out by
+ * Layout, such as a mapped file.  The storage is not freed.
+ **********************************************************************/
+  UpperDiagonalSquareMatrix(size_t sideLength, T *storage);
+
+
+/***********************************************************************
+ * Take over other's storage, leaving it an empty 0 x 0 matrix.
+ **********************************************************************/
+  UpperDiagonalSquareMatrix(UpperDiagonalSquareMatrix &&other);
+  UpperDiagonalSquareMatrix& operator=(UpperDiagonalSquareMatrix &&other);
+
+
+/***********************************************************************
+ * Matrices are not copied implicitly; both copies would free the same
+ * storage.
+ **********************************************************************/
+  UpperDiagonalSquareMatrix(const UpperDiagonalSquareMatrix&) = delete;
+  UpperDiagonalSquareMatrix& operator=(const UpperDiagonalSquareMatrix&)
+                                                                = delete;
+
+
+/***********************************************************************
+ * Free the storage if this matrix allocated it.
  **********************************************************************/
   ~UpperDiagonalSquareMatrix();
 
@@ -112,105 +362,225 @@ template<typename T> class UpperDiagonalSquareMatrix{
 
 
 /***********************************************************************
- *
+ * Zero every element.  Large matrices are zeroed in parallel with
+ * firstTouchZero(), so call this on a fresh matrix before the workers
+ * which fill it to place its pages near them.
  **********************************************************************/
     void zeroData();
 
+
+/***********************************************************************
+ * The packed storage: numberOfElements() values, for code which treats
+ * every stored element alike regardless of its position.  With a tiled
+ * layout this includes the padding.
+ **********************************************************************/
+    T* data();
+
+
+/***********************************************************************
+ * Walk the stored part of row y, (y, y) through (n-1, y).
+ **********************************************************************/
+    iterator rowBegin(size_t y);
+    iterator rowEnd(size_t y);
+
+
+/***********************************************************************
+ * Walk the stored part of column x, (x, 0) through (x, x).
+ **********************************************************************/
+    iterator columnBegin(size_t x);
+    iterator columnEnd(size_t x);
+
+
+/*******************************************************************//**
+ * \brief Copy out row y of the full symmetric matrix.
+ *
+ * @param[out] row Receives getSideLength() values, row[x] being the
+ * value at (x, y).
+ **********************************************************************/
+    void getRow(size_t y, T *row);
+
+
+/***********************************************************************
+ * A cursor starting at (x, y), x >= y, for filling or reading the
+ * triangle in row order without per element index arithmetic.
+ **********************************************************************/
+    cursor cursorAt(size_t x, size_t y);
+
+
+/*******************************************************************//**
+ * \brief The stored part of row y as one contiguous run, (y, y) first.
+ * Only available for layouts with contiguous rows.
+ *
+ * @return Pointer to (y, y) and the run length, n - y.
+ **********************************************************************/
+    std::pair<T*, size_t> getRowSpan(size_t y);
+
+
+/***********************************************************************
+ * How many values from (x, y), x >= y, rightward along the row are
+ * contiguous in storage.
+ **********************************************************************/
+    size_t getRunLength(size_t x, size_t y);
+
 };
 
 ////////////////////////////////////////////////////////////////////////
 //FUNCTION DEFINITIONS//////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-template<typename T> size_t UpperDiagonalSquareMatrix<T>::
-                                              XYtoW(size_t z, size_t u){
+template<typename T, typename Layout, typename A> size_t
+          UpperDiagonalSquareMatrix<T, Layout, A>::XYtoW(size_t z, size_t u){
   size_t x = z > u ? z : u;
   size_t y = z <= u? z : u;
-  return (y*n)+x-(y*(y-1)/2)-y;
+  return layout.offset(x, y);
 }
 
 
-template<typename T> std::pair<size_t, size_t>
-                        UpperDiagonalSquareMatrix<T>::WtoXY(csize_t w){
-  size_t x, y;
+template<typename T, typename Layout, typename A> std::pair<size_t, size_t>
+                UpperDiagonalSquareMatrix<T, Layout, A>::WtoXY(csize_t w){
   if(w >= numberOfElements()){
     return std::pair<size_t, size_t>(-1, -1);
   }
 
-  csize_t wPrime = numberOfElements() - w - 1;
-  y = n - floorl(0.5 + sqrtl(1L+8*wPrime)/2);
-  x = w - ((n*y) - (y * (y+1))/2);
-
-  return std::pair<size_t, size_t>(x, y);
+  return layout.position(w);
 }
 
 
-template<typename T> size_t UpperDiagonalSquareMatrix<T>::
-                                              numberOfElements(){
-  return (n*n)-(n * (n-1)) / 2;
+template<typename T, typename Layout, typename A> size_t
+                UpperDiagonalSquareMatrix<T, Layout, A>::numberOfElements(){
+  return layout.numberOfElements();
 }
 
 
-template<typename T> UpperDiagonalSquareMatrix<T>
-                      ::UpperDiagonalSquareMatrix(){
+template<typename T, typename Layout, typename A>
+        UpperDiagonalSquareMatrix<T, Layout, A>::UpperDiagonalSquareMatrix(){
   oneDMatrix = NULL;
+  n = 0;
+  layout.setSideLength(0);
+  ownsStorage = true;
 }
 
 
-template<typename T> UpperDiagonalSquareMatrix<T>
-                      ::UpperDiagonalSquareMatrix(size_t sideLength){
+template<typename T, typename Layout, typename A>
+                    UpperDiagonalSquareMatrix<T, Layout, A>
+                      ::UpperDiagonalSquareMatrix(size_t sideLength,
+                                                const A &allocator)
+                                                : allocator(allocator){
   //if(sideLength == 0){
   //  throw 22;
   //}
   n = sideLength;
+  layout.setSideLength(n);
+
+  oneDMatrix = std::allocator_traits<A>::allocate(this->allocator,
+                                                    numberOfElements());
+  ownsStorage = true;
+
+}
+
+
+template<typename T, typename Layout, typename A>
+                    UpperDiagonalSquareMatrix<T, Layout, A>
+              ::UpperDiagonalSquareMatrix(size_t sideLength, T *storage){
+  n = sideLength;
+  layout.setSideLength(n);
+  oneDMatrix = storage;
+  ownsStorage = false;
+}
+
+
+template<typename T, typename Layout, typename A>
+                    UpperDiagonalSquareMatrix<T, Layout, A>
+          ::UpperDiagonalSquareMatrix(UpperDiagonalSquareMatrix &&other)
+                                  : allocator(std::move(other.allocator)){
+  oneDMatrix = other.oneDMatrix;
+  n = other.n;
+  layout = other.layout;
+  ownsStorage = other.ownsStorage;
+
+  other.oneDMatrix = NULL;
+  other.n = 0;
+  other.layout.setSideLength(0);
+  other.ownsStorage = true;
+}
+
+
+template<typename T, typename Layout, typename A>
+                    UpperDiagonalSquareMatrix<T, Layout, A>&
+                    UpperDiagonalSquareMatrix<T, Layout, A>
+                  ::operator=(UpperDiagonalSquareMatrix &&other){
+  if(this == &other) return *this;
+
+  release();
+  allocator = std::move(other.allocator);
+  oneDMatrix = other.oneDMatrix;
+  n = other.n;
+  layout = other.layout;
+  ownsStorage = other.ownsStorage;
 
-  void *tmpPtr;
-  size_t allocSize = sizeof(T) * numberOfElements();
-  tmpPtr = malloc(allocSize);
-  oneDMatrix = (T*) tmpPtr;
+  other.oneDMatrix = NULL;
+  other.n = 0;
+  other.layout.setSideLength(0);
+  other.ownsStorage = true;
 
+  return *this;
 }
 
 
-template <typename T> UpperDiagonalSquareMatrix<T>
+template<typename T, typename Layout, typename A>
+                    UpperDiagonalSquareMatrix<T, Layout, A>
                                         ::~UpperDiagonalSquareMatrix(){
-  free(oneDMatrix);
+  release();
 }
 
 
-template <typename T> T UpperDiagonalSquareMatrix<T>
+template<typename T, typename Layout, typename A> void
+                      UpperDiagonalSquareMatrix<T, Layout, A>::release(){
+  if(ownsStorage && NULL != oneDMatrix){
+    std::allocator_traits<A>::deallocate(allocator, oneDMatrix,
+                                                    numberOfElements());
+  }
+  oneDMatrix = NULL;
+}
+
+
+template<typename T, typename Layout, typename A> T
+                    UpperDiagonalSquareMatrix<T, Layout, A>
                         ::getValueAtIndex(size_t x, size_t y){
   if(x >=n || y >= n) return oneDMatrix[-1];
 
   if(x >= y)
-    return oneDMatrix[XYtoW(x, y)];
+    return oneDMatrix[layout.offset(x, y)];
   else
-    return oneDMatrix[XYtoW(y, x)];
+    return oneDMatrix[layout.offset(y, x)];
 }
 
 
-template <typename T> T* UpperDiagonalSquareMatrix<T>
+template<typename T, typename Layout, typename A> T*
+                    UpperDiagonalSquareMatrix<T, Layout, A>
                         ::getReferenceForIndex(size_t x, size_t y){
   if(x >=n || y >= n) return NULL;
 
   if(x >= y)
-    return &oneDMatrix[XYtoW(x, y)];
+    return &oneDMatrix[layout.offset(x, y)];
   else
-    return &oneDMatrix[XYtoW(y, x)];
+    return &oneDMatrix[layout.offset(y, x)];
 }
 
 
-template <typename T> void UpperDiagonalSquareMatrix<T>
+template<typename T, typename Layout, typename A> void
+                                    UpperDiagonalSquareMatrix<T, Layout, A>
                     ::setValueAtIndex(size_t x, size_t y, T value){
   if(x >=n || y >= n) oneDMatrix[-1] = -1;
 
   if(x >= y)
-    oneDMatrix[XYtoW(x, y)] = value;
+    oneDMatrix[layout.offset(x, y)] = value;
   else
-    oneDMatrix[XYtoW(y, x)] = value;
+    oneDMatrix[layout.offset(y, x)] = value;
 }
 
-template <typename T> size_t UpperDiagonalSquareMatrix<T>
+template<typename T, typename Layout, typename A> size_t
+                                    UpperDiagonalSquareMatrix<T, Layout, A>
                                                 ::getSideLength(){
   return n;
 }
@@ -218,14 +588,83 @@ template <typename T> size_t UpperDiagonalSquareMatrix<T>
 
 //TODO: this is likely accelatatable, particularly with specific
 //template types, like u8.
-template <typename T> void UpperDiagonalSquareMatrix<T>::fill(T value){
+template<typename T, typename Layout, typename A> void
+                      UpperDiagonalSquareMatrix<T, Layout, A>::fill(T value){
   size_t endIndex = numberOfElements();
   for(size_t i = 0; i < endIndex; i++)
     oneDMatrix[i] = value;
 }
 
 
-template <typename T> void UpperDiagonalSquareMatrix<T>::zeroData(){
+template<typename T, typename Layout, typename A> void
+                        UpperDiagonalSquareMatrix<T, Layout, A>::zeroData(){
   size_t memSize = numberOfElements() * sizeof(T);
-  memset(oneDMatrix, 0, memSize);
+  firstTouchZero(oneDMatrix, memSize);
+}
+
+
+template<typename T, typename Layout, typename A> T*
+                            UpperDiagonalSquareMatrix<T, Layout, A>::data(){
+  return oneDMatrix;
+}
+
+
+template<typename T, typename Layout, typename A>
+                      typename UpperDiagonalSquareMatrix<T, Layout, A>::iterator
+                  UpperDiagonalSquareMatrix<T, Layout, A>::rowBegin(size_t y){
+  return iterator(oneDMatrix, &layout, y, y, true);
+}
+
+
+template<typename T, typename Layout, typename A>
+                      typename UpperDiagonalSquareMatrix<T, Layout, A>::iterator
+                    UpperDiagonalSquareMatrix<T, Layout, A>::rowEnd(size_t y){
+  return iterator(oneDMatrix, &layout, n, y, true);
+}
+
+
+template<typename T, typename Layout, typename A>
+                      typename UpperDiagonalSquareMatrix<T, Layout, A>::iterator
+              UpperDiagonalSquareMatrix<T, Layout, A>::columnBegin(size_t x){
+  return iterator(oneDMatrix, &layout, x, 0, false);
+}
+
+
+template<typename T, typename Layout, typename A>
+                      typename UpperDiagonalSquareMatrix<T, Layout, A>::iterator
+                UpperDiagonalSquareMatrix<T, Layout, A>::columnEnd(size_t x){
+  return iterator(oneDMatrix, &layout, x, x+1, false);
+}
+
+
+//Left of the diagonal the symmetric row is column y of the triangle;
+//from the diagonal rightward it is row y.
+template<typename T, typename Layout, typename A> void
+            UpperDiagonalSquareMatrix<T, Layout, A>::getRow(size_t y, T *row){
+  iterator end = columnEnd(y);
+  for(iterator it = columnBegin(y); it != end; ++it) row[it.index()] = *it;
+
+  end = rowEnd(y);
+  for(iterator it = ++rowBegin(y); it != end; ++it) row[it.index()] = *it;
+}
+
+
+template<typename T, typename Layout, typename A>
+                        typename UpperDiagonalSquareMatrix<T, Layout, A>::cursor
+          UpperDiagonalSquareMatrix<T, Layout, A>::cursorAt(size_t x, size_t y){
+  return cursor(oneDMatrix, &layout, n, x, y);
+}
+
+
+template<typename T, typename Layout, typename A> std::pair<T*, size_t>
+                  UpperDiagonalSquareMatrix<T, Layout, A>::getRowSpan(size_t y){
+  static_assert(Layout::CONTIGUOUS_ROWS,
+                          "getRowSpan() needs a layout with contiguous rows");
+  return std::pair<T*, size_t>(oneDMatrix + layout.offset(y, y), n - y);
+}
+
+
+template<typename T, typename Layout, typename A> size_t
+        UpperDiagonalSquareMatrix<T, Layout, A>::getRunLength(size_t x, size_t){
+  return layout.runInRow(x);
 }
@@ -0,0 +1,275 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <correlation-checkpoint.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE CONSTANTS AND STRUCTS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static const char CHECKPOINT_MAGIC[8] = {'M','A','D','L','C','K','P','T'};
+static cu32 CHECKPOINT_VERSION = 1;
+static csize_t CHECKPOINT_ALIGNMENT = 4096;
+
+
+struct checkpointHeader{
+  char magic[8];
+  u32 version;
+  u32 elementSize;
+  u64 numRows;
+  u64 numCols;
+  u64 tileSize;
+  u64 inputHash;
+  u64 numTiles;
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static size_t roundUpToAlignment(csize_t size){
+  return ((size + CHECKPOINT_ALIGNMENT-1) / CHECKPOINT_ALIGNMENT)
+                                                  * CHECKPOINT_ALIGNMENT;
+}
+
+
+//pread()/pwrite() may transfer less than asked; loop until done.
+static bool preadFully(int fd, void *buffer, size_t size, off_t offset){
+  u8 *at = (u8*) buffer;
+  while(size > 0){
+    ssize_t got = pread(fd, at, size, offset);
+    if(got < 0 && EINTR == errno) continue;
+    if(got <= 0) return false;
+    at += got;
+    size -= got;
+    offset += got;
+  }
+  return true;
+}
+
+
+static bool pwriteFully(int fd, const void *buffer, size_t size,
+                                                          off_t offset){
+  const u8 *at = (const u8*) buffer;
+  while(size > 0){
+    ssize_t put = pwrite(fd, at, size, offset);
+    if(put < 0 && EINTR == errno) continue;
+    if(put <= 0) return false;
+    at += put;
+    size -= put;
+    offset += put;
+  }
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+CorrelationCheckpoint::CorrelationCheckpoint(){
+  fd = -1;
+  numRows = numCols = tileSize = tilesPerSide = 0;
+  inputHash = 0;
+  bitmapOffset = dataOffset = 0;
+}
+
+
+CorrelationCheckpoint::~CorrelationCheckpoint(){
+  close();
+}
+
+
+bool CorrelationCheckpoint::open(const std::string &path,
+          csize_t numRows, csize_t numCols, csize_t tileSize,
+                            cu64 inputHash, const bool resume){
+  close();
+  if(0 == tileSize) return false;
+
+  this->numRows = numRows;
+  this->numCols = numCols;
+  this->tileSize = tileSize;
+  this->inputHash = inputHash;
+  tilesPerSide = (numRows + tileSize-1) / tileSize;
+
+  tileXY.clear();
+  tileXY.reserve((tilesPerSide * (tilesPerSide+1)) / 2);
+  for(size_t y = 0; y < tilesPerSide; y++)
+    for(size_t x = y; x < tilesPerSide; x++)
+      tileXY.push_back(std::pair<size_t, size_t>(x, y));
+
+  bitmap.assign((tileXY.size() + 7) / 8, 0);
+  bitmapOffset = CHECKPOINT_ALIGNMENT;
+  dataOffset = bitmapOffset + roundUpToAlignment(bitmap.size());
+
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if(fd < 0) return false;
+
+  if(resume && readHeaderAndBitmap()) return true;
+
+  //Fresh start: drop any old contents, then size the file so every
+  //tile has its slot.
+  bitmap.assign(bitmap.size(), 0);
+  csize_t tileBytes = tileSize * tileSize * sizeof(f64);
+  if(0 != ftruncate(fd, 0)
+  || 0 != ftruncate(fd, dataOffset + tileXY.size() * tileBytes)
+  || !writeHeaderAndBitmap()){
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+
+void CorrelationCheckpoint::close(){
+  if(fd >= 0) ::close(fd);
+  fd = -1;
+}
+
+
+bool CorrelationCheckpoint::readHeaderAndBitmap(){
+  checkpointHeader header;
+  if(!preadFully(fd, &header, sizeof(header), 0)) return false;
+
+  if(0 != memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic))
+  || CHECKPOINT_VERSION != header.version
+  || sizeof(f64) != header.elementSize
+  || numRows != header.numRows || numCols != header.numCols
+  || tileSize != header.tileSize || inputHash != header.inputHash
+  || tileXY.size() != header.numTiles){
+    return false;
+  }
+
+  return preadFully(fd, bitmap.data(), bitmap.size(), bitmapOffset);
+}
+
+
+bool CorrelationCheckpoint::writeHeaderAndBitmap(){
+  checkpointHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.elementSize = sizeof(f64);
+  header.numRows = numRows;
+  header.numCols = numCols;
+  header.tileSize = tileSize;
+  header.inputHash = inputHash;
+  header.numTiles = tileXY.size();
+
+  return pwriteFully(fd, &header, sizeof(header), 0)
+      && pwriteFully(fd, bitmap.data(), bitmap.size(), bitmapOffset)
+      && 0 == fdatasync(fd);
+}
+
+
+size_t CorrelationCheckpoint::numberOfTiles() const{
+  return tileXY.size();
+}
+
+
+size_t CorrelationCheckpoint::getTileSize() const{
+  return tileSize;
+}
+
+
+std::pair<size_t, size_t> CorrelationCheckpoint::tileCoordinates(
+                                                  csize_t tile) const{
+  return tileXY[tile];
+}
+
+
+size_t CorrelationCheckpoint::numberOfCompletedTiles(){
+  std::lock_guard<std::mutex> guard(bitmapLock);
+  size_t tr = 0;
+  for(size_t tile = 0; tile < tileXY.size(); tile++)
+    tr += (bitmap[tile / 8] >> (tile % 8)) & 1;
+  return tr;
+}
+
+
+bool CorrelationCheckpoint::isTileComplete(csize_t tile){
+  std::lock_guard<std::mutex> guard(bitmapLock);
+  return (bitmap[tile / 8] >> (tile % 8)) & 1;
+}
+
+
+bool CorrelationCheckpoint::writeTile(csize_t tile, cf64 *values){
+  if(fd < 0 || tile >= tileXY.size()) return false;
+
+  csize_t tileBytes = tileSize * tileSize * sizeof(f64);
+  if(!pwriteFully(fd, values, tileBytes, dataOffset + tile * tileBytes)
+  || 0 != fdatasync(fd)){
+    return false;
+  }
+
+  //Only after the values are durable may the tile be marked complete.
+  std::lock_guard<std::mutex> guard(bitmapLock);
+  bitmap[tile / 8] |= (u8) (1 << (tile % 8));
+  return pwriteFully(fd, &bitmap[tile / 8], 1, bitmapOffset + tile / 8)
+      && 0 == fdatasync(fd);
+}
+
+
+bool CorrelationCheckpoint::readTile(csize_t tile, f64 *values){
+  if(fd < 0 || tile >= tileXY.size()) return false;
+
+  csize_t tileBytes = tileSize * tileSize * sizeof(f64);
+  return preadFully(fd, values, tileBytes, dataOffset + tile * tileBytes);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+u64 hashExpressionData(const std::vector<std::vector<double> > &data){
+  u64 tr = 14695981039346656037ULL;
+
+  for(size_t y = 0; y < data.size(); y++){
+    cu8 *bytes = (cu8*) data[y].data();
+    csize_t size = data[y].size() * sizeof(double);
+    for(size_t i = 0; i < size; i++){
+      tr ^= bytes[i];
+      tr *= 1099511628211ULL;
+    }
+  }
+
+  return tr;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
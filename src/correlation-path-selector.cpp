@@ -0,0 +1,422 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <correlation-path-selector.hpp>
+#include <statistics.hpp>
+#include <upper-diagonal-square-matrix.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE CONSTANTS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static const char COST_MODEL_MAGIC[] = "madlib-correlation-cost-model";
+static const int COST_MODEL_VERSION = 2;
+
+static const size_t CALIBRATION_COLUMNS[COST_MODEL_SAMPLES] =
+                                  {4, 8, 16, 32, 64, 128, 256, 1024};
+
+//Minimum wall time of a single measurement, to rise above timer noise.
+static const f64 CALIBRATION_MIN_NS = 500000.0;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/***********************************************************************
+ * \brief Interpolate the per pair cost for a column count from the
+ * sampled column counts.
+ **********************************************************************/
+static f64 pairCostFor(const correlationCostModel &model,
+                          correlationKernel kernel, csize_t numCols);
+
+
+/***********************************************************************
+ * \brief Time one Pearson pair correlation for numCols columns.
+ **********************************************************************/
+static f64 measurePairCost(csize_t numCols);
+
+
+/***********************************************************************
+ * \brief Time one Kendall pair tally for numCols columns, as in the
+ * Kendall engine's helpers.
+ **********************************************************************/
+static f64 measureKendallPairCost(csize_t numCols);
+
+
+/***********************************************************************
+ * \brief Time one setValueAtIndex() on a packed triangle.
+ **********************************************************************/
+static f64 measureTriangleStoreCost();
+
+
+/***********************************************************************
+ * \brief Time per value of getRow() on a packed triangle, as the
+ * engines do when extracting requested rows.
+ **********************************************************************/
+static f64 measureExtractionCost();
+
+
+/***********************************************************************
+ * \brief mkdir -p for the directory portion of path.
+ **********************************************************************/
+static bool makeParentDirectories(const std::string &path);
+
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static f64 nanosecondsSince(
+                std::chrono::steady_clock::time_point start){
+  return std::chrono::duration<f64, std::nano>(
+                          std::chrono::steady_clock::now() - start).count();
+}
+
+
+static f64 pairCostFor(const correlationCostModel &model,
+                          correlationKernel kernel, csize_t numCols){
+  const size_t *m = model.sampleColumns;
+  cf64 *c = model.pairCost[kernel];
+
+  if(numCols <= m[0]){
+    return c[0] * numCols / m[0];
+  }
+
+  size_t i = 1;
+  while(i < COST_MODEL_SAMPLES-1 && m[i] < numCols) i++;
+
+  //Linear between neighbouring samples, and continuing the final slope
+  //past the largest sample.
+  cf64 slope = (c[i] - c[i-1]) / (f64) (m[i] - m[i-1]);
+  cf64 estimate = c[i-1] + slope * (f64) (numCols - m[i-1]);
+  return estimate > 0 ? estimate : c[i-1];
+}
+
+
+f64 estimateCorrelationPathCost(const correlationCostModel &model,
+                        correlationKernel kernel,
+                        correlationPath path, csize_t numRows,
+                        csize_t numCols, csize_t againstRowsLength,
+                                                  csize_t numThreads){
+  csize_t threads = numThreads > 0 ? numThreads : 1;
+  cf64 pairCost = pairCostFor(model, kernel, numCols);
+
+  if(CORRELATION_PATH_CROSS_REFERENCE == path){
+    //Work is split by requested row, so fewer requested rows than
+    //threads leaves threads idle.
+    csize_t rowsPerThread = (againstRowsLength + threads-1) / threads;
+    return (f64) rowsPerThread * numRows * pairCost;
+  }
+
+  csize_t numElements = (numRows * (numRows+1)) / 2;
+  csize_t elementsPerThread = (numElements + threads-1) / threads;
+  return (f64) elementsPerThread * (pairCost + model.triangleStoreCost)
+        + (f64) againstRowsLength * numRows * model.extractionCost;
+}
+
+
+correlationPath selectCorrelationPath(const correlationCostModel &model,
+                        correlationKernel kernel,
+                        csize_t numRows, csize_t numCols,
+                        csize_t againstRowsLength, csize_t numThreads){
+  if(againstRowsLength >= numRows) return CORRELATION_PATH_BRUTE_FORCE;
+
+  cf64 crossReference = estimateCorrelationPathCost(model, kernel,
+                CORRELATION_PATH_CROSS_REFERENCE, numRows, numCols,
+                                      againstRowsLength, numThreads);
+  cf64 bruteForce = estimateCorrelationPathCost(model, kernel,
+                CORRELATION_PATH_BRUTE_FORCE, numRows, numCols,
+                                      againstRowsLength, numThreads);
+
+  return crossReference <= bruteForce ? CORRELATION_PATH_CROSS_REFERENCE
+                                      : CORRELATION_PATH_BRUTE_FORCE;
+}
+
+
+correlationPath selectCorrelationPath(correlationKernel kernel,
+                        csize_t numRows, csize_t numCols,
+                        csize_t againstRowsLength, csize_t numThreads){
+  if(againstRowsLength >= numRows) return CORRELATION_PATH_BRUTE_FORCE;
+
+  return selectCorrelationPath(getCorrelationCostModel(), kernel,
+                    numRows, numCols, againstRowsLength, numThreads);
+}
+
+
+const correlationCostModel& getCorrelationCostModel(){
+  static const correlationCostModel model = [](){
+    correlationCostModel tr;
+    const std::string path = correlationCostModelPath();
+
+    if(!path.empty() && loadCorrelationCostModel(path, tr)) return tr;
+
+    tr = calibrateCorrelationCostModel();
+    if(!path.empty()) saveCorrelationCostModel(path, tr);
+    return tr;
+  }();
+
+  return model;
+}
+
+
+static f64 measurePairCost(csize_t numCols){
+  const size_t numRows = 64;
+  std::vector<std::vector<f64> > rows(numRows, std::vector<f64>(numCols));
+  std::vector<f64> sumsOfSquares(numRows);
+
+  for(size_t y = 0; y < numRows; y++){
+    for(size_t x = 0; x < numCols; x++)
+      rows[y][x] = (f64) ((x * 7 + y * 13) % 17) - 8.0;
+    sumsOfSquares[y] = getSumOfSquares(rows[y].data(), numCols);
+  }
+
+  sumOfMultipliedArraysFunction crossSum =
+                                  selectSumOfMultipliedArrays(numCols);
+  volatile f64 sink = 0;
+  size_t pairs = 0;
+  const auto start = std::chrono::steady_clock::now();
+  f64 elapsed;
+
+  do{
+    for(size_t y = 0; y < numRows; y++){
+      f64 acc = 0;
+      for(size_t x = 0; x < numRows; x++){
+        acc += getCenteredCorrelationBasic(sumsOfSquares[x],
+                  sumsOfSquares[y], crossSum(rows[x].data(),
+                                          rows[y].data(), numCols));
+      }
+      sink = sink + acc;
+    }
+    pairs += numRows * numRows;
+    elapsed = nanosecondsSince(start);
+  }while(elapsed < CALIBRATION_MIN_NS);
+
+  return elapsed / pairs;
+}
+
+
+static f64 measureKendallPairCost(csize_t numCols){
+  const size_t numRows = 64;
+  std::vector<std::vector<f64> > rows(numRows, std::vector<f64>(numCols));
+
+  for(size_t y = 0; y < numRows; y++)
+    for(size_t x = 0; x < numCols; x++)
+      rows[y][x] = (f64) ((x * 7 + y * 13) % 17);
+
+  volatile f64 sink = 0;
+  size_t pairs = 0;
+  const auto start = std::chrono::steady_clock::now();
+  f64 elapsed;
+
+  do{
+    for(size_t y = 0; y < numRows; y++){
+      f64 acc = 0;
+      for(size_t x = 0; x < numRows; x++){
+        ssize_t tally = 0;
+        for(size_t i = 0; i < numCols; i++)
+          tally += rows[x][i] == rows[y][i] ? 1 : -1;
+        acc += ((f64) (tally * 2)) / (numCols * (numCols-1));
+      }
+      sink = sink + acc;
+    }
+    pairs += numRows * numRows;
+    elapsed = nanosecondsSince(start);
+  }while(elapsed < CALIBRATION_MIN_NS);
+
+  return elapsed / pairs;
+}
+
+
+static f64 measureTriangleStoreCost(){
+  const size_t sideLength = 512;
+  UpperDiagonalSquareMatrix<f64> triangle(sideLength);
+  size_t stores = 0;
+  const auto start = std::chrono::steady_clock::now();
+  f64 elapsed;
+
+  do{
+    for(size_t y = 0; y < sideLength; y++)
+      for(size_t x = y; x < sideLength; x++)
+        triangle.setValueAtIndex(x, y, (f64) x);
+    stores += triangle.numberOfElements();
+    elapsed = nanosecondsSince(start);
+  }while(elapsed < CALIBRATION_MIN_NS);
+
+  volatile f64 sink = triangle.getValueAtIndex(1, 0);
+  (void) sink;
+  return elapsed / stores;
+}
+
+
+static f64 measureExtractionCost(){
+  //Large enough that walking a column leaves the cache, as it does for
+  //any matrix worth choosing a strategy for.
+  const size_t sideLength = 2048;
+  const size_t stride = 61;
+  UpperDiagonalSquareMatrix<f64> triangle(sideLength);
+  triangle.zeroData();
+
+  std::vector<f64> row(sideLength);
+  volatile f64 sink = 0;
+  size_t loads = 0;
+  size_t y = 0;
+  const auto start = std::chrono::steady_clock::now();
+  f64 elapsed;
+
+  do{
+    y = (y + stride) % sideLength;
+    triangle.getRow(y, row.data());
+    sink = sink + row[sideLength / 2];
+    loads += sideLength;
+    elapsed = nanosecondsSince(start);
+  }while(elapsed < CALIBRATION_MIN_NS);
+
+  return elapsed / loads;
+}
+
+
+correlationCostModel calibrateCorrelationCostModel(){
+  correlationCostModel tr;
+
+  for(size_t i = 0; i < COST_MODEL_SAMPLES; i++){
+    tr.sampleColumns[i] = CALIBRATION_COLUMNS[i];
+    tr.pairCost[CORRELATION_KERNEL_PEARSON][i] =
+                                  measurePairCost(CALIBRATION_COLUMNS[i]);
+    tr.pairCost[CORRELATION_KERNEL_KENDALL][i] =
+                            measureKendallPairCost(CALIBRATION_COLUMNS[i]);
+  }
+  tr.triangleStoreCost = measureTriangleStoreCost();
+  tr.extractionCost = measureExtractionCost();
+
+  return tr;
+}
+
+
+std::string correlationCostModelPath(){
+  const char *explicitPath = getenv("MADLIB_COST_MODEL");
+  if(NULL != explicitPath && '\0' != explicitPath[0]) return explicitPath;
+
+  const char *cacheHome = getenv("XDG_CACHE_HOME");
+  if(NULL != cacheHome && '\0' != cacheHome[0]){
+    return std::string(cacheHome) + "/madlib/correlation-cost-model";
+  }
+
+  const char *home = getenv("HOME");
+  if(NULL != home && '\0' != home[0]){
+    return std::string(home) + "/.cache/madlib/correlation-cost-model";
+  }
+
+  return std::string();
+}
+
+
+bool loadCorrelationCostModel(const std::string &path,
+                                          correlationCostModel &model){
+  FILE *in = fopen(path.c_str(), "r");
+  if(NULL == in) return false;
+
+  correlationCostModel tmp;
+  char magic[64];
+  int version;
+  bool valid = 2 == fscanf(in, "%63s %d", magic, &version)
+            && 0 == strcmp(magic, COST_MODEL_MAGIC)
+            && COST_MODEL_VERSION == version;
+
+  for(size_t i = 0; valid && i < COST_MODEL_SAMPLES; i++){
+    valid = 1 == fscanf(in, " sample %zu", &tmp.sampleColumns[i])
+         && tmp.sampleColumns[i] > 0
+         && (0 == i || tmp.sampleColumns[i] > tmp.sampleColumns[i-1]);
+    for(size_t k = 0; valid && k < CORRELATION_KERNELS; k++){
+      valid = 1 == fscanf(in, " %lf", &tmp.pairCost[k][i])
+           && tmp.pairCost[k][i] > 0;
+    }
+  }
+  valid = valid
+     && 1 == fscanf(in, " triangleStoreCost %lf", &tmp.triangleStoreCost)
+     && 1 == fscanf(in, " extractionCost %lf", &tmp.extractionCost)
+     && tmp.triangleStoreCost >= 0 && tmp.extractionCost >= 0;
+
+  fclose(in);
+  if(valid) model = tmp;
+  return valid;
+}
+
+
+static bool makeParentDirectories(const std::string &path){
+  for(size_t slash = path.find('/', 1); std::string::npos != slash;
+                                  slash = path.find('/', slash+1)){
+    const std::string directory = path.substr(0, slash);
+    if(0 != mkdir(directory.c_str(), 0755) && EEXIST != errno){
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool saveCorrelationCostModel(const std::string &path,
+                                    const correlationCostModel &model){
+  if(!makeParentDirectories(path)) return false;
+
+  //Write then rename so concurrent readers never see a partial file.
+  const std::string tmpPath = path + "." + std::to_string(getpid())
+                                                              + ".tmp";
+  FILE *out = fopen(tmpPath.c_str(), "w");
+  if(NULL == out) return false;
+
+  fprintf(out, "%s %d\n", COST_MODEL_MAGIC, COST_MODEL_VERSION);
+  for(size_t i = 0; i < COST_MODEL_SAMPLES; i++){
+    fprintf(out, "sample %zu", model.sampleColumns[i]);
+    for(size_t k = 0; k < CORRELATION_KERNELS; k++)
+      fprintf(out, " %.9g", model.pairCost[k][i]);
+    fprintf(out, "\n");
+  }
+  fprintf(out, "triangleStoreCost %.9g\n", model.triangleStoreCost);
+  fprintf(out, "extractionCost %.9g\n", model.extractionCost);
+
+  bool success = 0 == ferror(out);
+  success = 0 == fclose(out) && success;
+  success = success && 0 == rename(tmpPath.c_str(), path.c_str());
+  if(!success) remove(tmpPath.c_str());
+
+  return success;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,319 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <correlation-transforms.hpp>
+#include <simple-thread-dispatch.hpp>
+#include <statistics.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE CONSTANTS AND STRUCTS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Below this many values the p-value table costs more than it saves.
+static csize_t P_VALUE_TABLE_MINIMUM_COUNT = 1 << 16;
+static csize_t P_VALUE_TABLE_FIRST_INTERVALS = 1 << 12;
+static csize_t P_VALUE_TABLE_MAXIMUM_INTERVALS = 1 << 16;
+
+
+/***********************************************************************
+ * h(r) = log p(r) - (df/2) log(1 - r^2) sampled at r = i / intervals,
+ * stored from i = -1 to intervals + 1 so every cubic has 4 nodes.
+ **********************************************************************/
+struct pValueTable{
+  std::vector<f64> nodes;
+  size_t intervals;
+  f64 halfDegreesOfFreedom;
+};
+
+
+struct correlationTransformStruct{
+  f64 *values;
+  size_t count;
+  f64 degreesOfFreedom;
+  correlationTransform transform;
+  bool exact;
+  const pValueTable *table;
+};
+
+typedef struct correlationTransformStruct CTS;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Helper function to transformCorrelations() used with
+ * simple-thread-dispatch().
+ **********************************************************************/
+void *correlationTransformHelper(void *protoArgs);
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//log(x) for finite positive normal x.  With m in [sqrt(1/2), sqrt(2)),
+//s = (m-1)/(m+1) has |s| < 0.172 and log(m) = 2 atanh(s); the series is
+//cut after s^19, leaving a truncation error below 4e-16.
+static inline f64 fastLog(cf64 x){
+  u64 bits;
+  memcpy(&bits, &x, sizeof(bits));
+  f64 exponent = (f64) (s64) ((bits >> 52) & 0x7ff) - 1023;
+  bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  f64 m;
+  memcpy(&m, &bits, sizeof(m));
+
+  cf64 high = m > M_SQRT2 ? 1.0 : 0.0;
+  m *= 1.0 - 0.5 * high;
+  exponent += high;
+
+  cf64 s = (m - 1) / (m + 1);
+  cf64 s2 = s * s;
+  cf64 series = 1 + s2*(1.0/3 + s2*(1.0/5 + s2*(1.0/7 + s2*(1.0/9
+              + s2*(1.0/11 + s2*(1.0/13 + s2*(1.0/15 + s2*(1.0/17
+              + s2*(1.0/19)))))))));
+  return exponent * M_LN2 + 2 * s * series;
+}
+
+
+//exp(x), 0 below -708.  x = k ln2 + f with |f| <= ln2/2, and exp(f)
+//from its Taylor series through f^14 (truncation below 2e-18).
+static inline f64 fastExp(cf64 x){
+  cf64 clamped = x < -708 ? -708 : (x > 709 ? 709 : x);
+  cf64 k = nearbyint(clamped * M_LOG2E);
+  //ln2 split so k * ln2High is exact.
+  cf64 ln2High = 6.93145751953125e-1, ln2Low = 1.42860682030941723212e-6;
+  cf64 f = (clamped - k * ln2High) - k * ln2Low;
+
+  f64 p = 1.0/87178291200;
+  p = p*f + 1.0/6227020800;
+  p = p*f + 1.0/479001600;
+  p = p*f + 1.0/39916800;
+  p = p*f + 1.0/3628800;
+  p = p*f + 1.0/362880;
+  p = p*f + 1.0/40320;
+  p = p*f + 1.0/5040;
+  p = p*f + 1.0/720;
+  p = p*f + 1.0/120;
+  p = p*f + 1.0/24;
+  p = p*f + 1.0/6;
+  p = p*f + 0.5;
+  p = p*f + 1;
+  p = p*f + 1;
+
+  cu64 scaleBits = (u64) ((s64) k + 1023) << 52;
+  f64 scale;
+  memcpy(&scale, &scaleBits, sizeof(scale));
+  return x < -708 ? 0 : p * scale;
+}
+
+
+//atanh(r) for |r| < 1.  Near 0 the series in r itself is used so small
+//coefficients keep full relative precision; elsewhere the log form.
+static inline f64 fastAtanh(cf64 r){
+  cf64 r2 = r * r;
+  cf64 series = r * (1 + r2*(1.0/3 + r2*(1.0/5 + r2*(1.0/7 + r2*(1.0/9
+              + r2*(1.0/11 + r2*(1.0/13 + r2*(1.0/15 + r2*(1.0/17
+              + r2*(1.0/19))))))))));
+  cf64 ratio = (1 + r) / (1 - r);
+  cf64 viaLog = 0.5 * fastLog(ratio > 0 ? ratio : 1);
+  return fabs(r) < 0.17 ? series : viaLog;
+}
+
+
+//Clamp to [-1, 1], letting NaN through unlike fmin()/fmax().
+static inline f64 clampCorrelation(cf64 r){
+  return r > 1 ? 1 : (r < -1 ? -1 : r);
+}
+
+
+static f64 exactLogPValueResidual(cf64 r, cf64 a){
+  cf64 x = (1 - r) * (1 + r);
+  if(x <= 0)
+    return lgamma(a + 0.5) - lgamma(a) - lgamma(0.5) - log(a);
+  return logRegularizedIncompleteBeta(a, 0.5, x, r * r) - a * log(x);
+}
+
+
+static f64 interpolatePValueResidual(const pValueTable &table, cf64 r){
+  cf64 position = r * table.intervals;
+  size_t i = (size_t) position;
+  if(i >= table.intervals) i = table.intervals - 1;
+  cf64 t = position - i;
+
+  cf64 *p = table.nodes.data() + i;
+  return p[1] + 0.5 * t * ((p[2] - p[0])
+              + t * ((2*p[0] - 5*p[1] + 4*p[2] - p[3])
+              + t * (3*(p[1] - p[2]) + p[3] - p[0])));
+}
+
+
+//Build the table, refining until the interpolation error is within
+//tolerance.  Returns false if it never is.
+static bool buildPValueTable(pValueTable &table, cf64 degreesOfFreedom){
+  cf64 a = degreesOfFreedom / 2;
+  table.halfDegreesOfFreedom = a;
+
+  for(size_t intervals = P_VALUE_TABLE_FIRST_INTERVALS;
+      intervals <= P_VALUE_TABLE_MAXIMUM_INTERVALS; intervals *= 2){
+    table.intervals = intervals;
+    table.nodes.resize(intervals + 3);
+    for(size_t i = 0; i <= intervals; i++)
+      table.nodes[i+1] = exactLogPValueResidual((f64) i / intervals, a);
+    //p(r) = 1 - (odd series in r), so its smooth continuation below 0
+    //is 2 - p(-r); past r = 1 extrapolate with a cubic.
+    cf64 firstX = 1 - 1.0 / ((f64) intervals * intervals);
+    table.nodes[0] = log(2 - exp(table.nodes[2] + a * log(firstX)))
+                                                      - a * log(firstX);
+    f64 *end = table.nodes.data() + intervals + 1;
+    end[1] = 4 * end[0] - 6 * end[-1] + 4 * end[-2] - end[-3];
+
+    //The cubic's error is not largest at the midpoint, so sample each
+    //interval at its quarter points too.
+    f64 worst = 0;
+    for(size_t i = 0; i < intervals; i++){
+      for(f64 t = 0.25; t < 1; t += 0.25){
+        cf64 r = (i + t) / intervals;
+        cf64 error = fabs(interpolatePValueResidual(table, r)
+                                        - exactLogPValueResidual(r, a));
+        if(!(error <= worst)) worst = error;
+      }
+    }
+
+    //An absolute error e in log p is a relative error of about e in p.
+    if(worst <= CORRELATION_P_VALUE_TOLERANCE) return true;
+  }
+
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+void transformCorrelations(f64 *values, csize_t count, csize_t numSamples,
+                const correlationTransform transform, const bool exact){
+  cf64 degreesOfFreedom = numSamples > 2 ? (f64) (numSamples - 2) : NAN;
+
+  pValueTable table;
+  bool useTable = false;
+  if(CORRELATION_TO_P_VALUE == transform && !exact && !isnan(degreesOfFreedom)
+  && count >= P_VALUE_TABLE_MINIMUM_COUNT){
+    useTable = buildPValueTable(table, degreesOfFreedom);
+  }
+
+  CTS instructions = {
+      values,
+      count,
+      degreesOfFreedom,
+      transform,
+      exact || (CORRELATION_TO_P_VALUE == transform && !useTable),
+      useTable ? &table : NULL
+    };
+
+  autoThreadLauncher(correlationTransformHelper, (void*) &instructions);
+}
+
+
+void transformCorrelationMatrix(UpperDiagonalSquareMatrix<f64> &matrix,
+              csize_t numSamples, const correlationTransform transform,
+                                                    const bool exact){
+  transformCorrelations(matrix.data(), matrix.numberOfElements(),
+                                        numSamples, transform, exact);
+}
+
+
+void *correlationTransformHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  CTS *args = (CTS*) arg->specifics;
+  f64 *values = args->values;
+  cf64 df = args->degreesOfFreedom;
+  const pValueTable *table = args->table;
+
+  csize_t minimum = (args->count * numerator) / denominator;
+  csize_t maximum = (args->count * (numerator+1)) / denominator;
+
+  switch(args->transform){
+    case CORRELATION_TO_FISHER_Z:
+      if(args->exact){
+        for(size_t i = minimum; i < maximum; i++){
+          cf64 r = clampCorrelation(values[i]);
+          values[i] = atanh(r);
+        }
+      }else{
+        for(size_t i = minimum; i < maximum; i++){
+          cf64 r = clampCorrelation(values[i]);
+          cf64 z = fastAtanh(fabs(r) < 1 ? r : 0);
+          values[i] = isnan(r) ? r : (fabs(r) < 1 ? z : copysign(INFINITY, r));
+        }
+      }
+      break;
+
+    case CORRELATION_TO_T_STATISTIC:
+      for(size_t i = minimum; i < maximum; i++){
+        cf64 r = clampCorrelation(values[i]);
+        values[i] = r * sqrt(df / ((1 - r) * (1 + r)));
+      }
+      break;
+
+    case CORRELATION_TO_P_VALUE:
+      if(args->exact){
+        for(size_t i = minimum; i < maximum; i++){
+          cf64 r = clampCorrelation(values[i]);
+          values[i] = isnan(r) || isnan(df) ? NAN :
+          regularizedIncompleteBeta(df / 2, 0.5, (1 - r) * (1 + r), r * r);
+        }
+      }else{
+        cf64 a = table->halfDegreesOfFreedom;
+        for(size_t i = minimum; i < maximum; i++){
+          cf64 r = fmin(1.0, fabs(values[i]));
+          cf64 x = (1 - r) * (1 + r);
+          cf64 logP = interpolatePValueResidual(*table, r)
+                                        + a * fastLog(x > 0 ? x : 1);
+          cf64 p = fmin(1.0, fastExp(logP));
+          values[i] = isnan(values[i]) ? NAN : (x > 0 ? p : 0);
+        }
+      }
+      break;
+  }
+
+  return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,220 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+
+#include <differential-expression.hpp>
+#include <simple-thread-dispatch.hpp>
+#include <statistics.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STRUCTS///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct groupTestStruct{
+  const std::vector<std::vector<double> > *expressionData;
+  //Column indices ordered by group.
+  std::vector<size_t> *order;
+  //groupStart[g] to groupStart[g+1] is the range of order in group g.
+  std::vector<size_t> *groupStart;
+  //Groups with at least one column.
+  size_t usedGroups;
+  groupTest test;
+  groupTestResults *results;
+};
+
+typedef struct groupTestStruct GTS;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Helper function to calculateGroupTests() used with
+ * simple-thread-dispatch().
+ **********************************************************************/
+void *groupTestHelper(void *protoArgs);
+
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+groupTestResults calculateGroupTests(
+            const std::vector<std::vector<double> > &expressionData,
+            const std::vector<size_t> &groups, const groupTest test){
+  groupTestResults tr;
+  csize_t numRows = expressionData.size();
+  csize_t numCols = groups.size();
+
+  size_t numGroups = 0;
+  for(size_t x = 0; x < numCols; x++)
+    if(groups[x] + 1 > numGroups) numGroups = groups[x] + 1;
+  if(ONE_WAY_ANOVA != test && 2 != numGroups) return tr;
+  if(numGroups < 2) return tr;
+  for(size_t y = 0; y < numRows; y++)
+    if(expressionData[y].size() != numCols) return tr;
+
+  //Counting sort of the columns by group.
+  std::vector<size_t> groupStart(numGroups + 1, 0);
+  for(size_t x = 0; x < numCols; x++) groupStart[groups[x] + 1]++;
+  for(size_t g = 0; g < numGroups; g++) groupStart[g+1] += groupStart[g];
+  std::vector<size_t> order(numCols), next(groupStart);
+  for(size_t x = 0; x < numCols; x++) order[next[groups[x]]++] = x;
+
+  //Unused labels are not groups, and must not count towards the degrees
+  //of freedom.
+  size_t usedGroups = 0;
+  for(size_t g = 0; g < numGroups; g++)
+    if(groupStart[g+1] > groupStart[g]) usedGroups++;
+  if(usedGroups < 2) return tr;
+
+  tr.statistic.resize(numRows);
+  tr.degreesOfFreedom.resize(numRows);
+  tr.pValue.resize(numRows);
+
+  GTS instructions = {
+      &expressionData,
+      &order,
+      &groupStart,
+      usedGroups,
+      test,
+      &tr
+    };
+
+  autoThreadLauncher(groupTestHelper, (void*) &instructions);
+
+  return tr;
+}
+
+
+void *groupTestHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  GTS *args = (GTS*) arg->specifics;
+  const std::vector<std::vector<double> > &expressionData =
+                                                  *args->expressionData;
+  const std::vector<size_t> &order = *args->order;
+  const std::vector<size_t> &groupStart = *args->groupStart;
+  groupTestResults &results = *args->results;
+  csize_t numRows = expressionData.size();
+  csize_t numCols = order.size();
+  csize_t numGroups = groupStart.size() - 1;
+
+  csize_t minimum = (numRows * numerator) / denominator;
+  csize_t maximum = (numRows * (numerator+1)) / denominator;
+
+  std::vector<f64> gathered(numCols);
+  std::vector<f64> sums(numGroups), sumsOfSquares(numGroups);
+
+  for(size_t y = minimum; y < maximum; y++){
+    cf64 *row = expressionData[y].data();
+    cf64 shift = row[0];
+    for(size_t x = 0; x < numCols; x++) gathered[x] = row[order[x]] - shift;
+
+    //One fused pass per group, with split accumulators so the compiler
+    //can keep several vector lanes busy.
+    for(size_t g = 0; g < numGroups; g++){
+      cf64 *values = gathered.data() + groupStart[g];
+      csize_t size = groupStart[g+1] - groupStart[g];
+      f64 s[4] = {0, 0, 0, 0}, q[4] = {0, 0, 0, 0};
+      size_t i = 0;
+      for(; i + 4 <= size; i += 4){
+        for(size_t k = 0; k < 4; k++){
+          s[k] += values[i+k];
+          q[k] += values[i+k] * values[i+k];
+        }
+      }
+      for(; i < size; i++){
+        s[0] += values[i];
+        q[0] += values[i] * values[i];
+      }
+      sums[g] = (s[0] + s[1]) + (s[2] + s[3]);
+      sumsOfSquares[g] = (q[0] + q[1]) + (q[2] + q[3]);
+    }
+
+    f64 statistic = NAN, degreesOfFreedom = NAN, pValue = NAN;
+
+    if(ONE_WAY_ANOVA == args->test){
+      f64 total = 0, between = 0, within = 0;
+      for(size_t g = 0; g < numGroups; g++) total += sums[g];
+      for(size_t g = 0; g < numGroups; g++){
+        csize_t n = groupStart[g+1] - groupStart[g];
+        if(0 == n) continue;
+        between += sums[g] * sums[g] / n;
+        within += sumsOfSquares[g] - sums[g] * sums[g] / n;
+      }
+      between -= total * total / numCols;
+
+      cf64 dfBetween = args->usedGroups - 1;
+      degreesOfFreedom = (f64) numCols - args->usedGroups;
+      if(degreesOfFreedom > 0 && within > 0){
+        statistic = (between / dfBetween) / (within / degreesOfFreedom);
+        pValue = getFPValue(statistic, dfBetween, degreesOfFreedom);
+      }
+    }else{
+      cf64 n0 = groupStart[1] - groupStart[0];
+      cf64 n1 = groupStart[2] - groupStart[1];
+      if(n0 > 1 && n1 > 1){
+        cf64 mean0 = sums[0] / n0, mean1 = sums[1] / n1;
+        cf64 ss0 = sumsOfSquares[0] - sums[0] * mean0;
+        cf64 ss1 = sumsOfSquares[1] - sums[1] * mean1;
+        f64 standardError;
+
+        if(STUDENT_T_TEST == args->test){
+          degreesOfFreedom = n0 + n1 - 2;
+          cf64 pooled = (ss0 + ss1) / degreesOfFreedom;
+          standardError = sqrt(pooled * (1 / n0 + 1 / n1));
+        }else{
+          cf64 v0 = ss0 / (n0 - 1) / n0, v1 = ss1 / (n1 - 1) / n1;
+          standardError = sqrt(v0 + v1);
+          degreesOfFreedom = (v0 + v1) * (v0 + v1)
+                  / (v0 * v0 / (n0 - 1) + v1 * v1 / (n1 - 1));
+        }
+
+        if(standardError > 0){
+          statistic = (mean0 - mean1) / standardError;
+          pValue = getStudentTPValue(statistic, degreesOfFreedom);
+        }
+      }
+    }
+
+    results.statistic[y] = statistic;
+    results.degreesOfFreedom[y] = degreesOfFreedom;
+    results.pValue[y] = pValue;
+  }
+
+  return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
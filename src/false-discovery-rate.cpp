@@ -0,0 +1,443 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include <false-discovery-rate.hpp>
+#include <simple-thread-dispatch.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STRUCTS///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct benjaminiHochbergStruct{
+  cf64 *pValues;
+  size_t count;
+  UpperDiagonalSquareMatrix<f64> *matrix;
+  //One per worker, indexed by numerator.
+  std::vector<BenjaminiHochbergThreshold> *parts;
+  f64 threshold;
+  u8 *rejected;
+  UpperDiagonalSquareMatrix<u8> *rejectedMatrix;
+  //Rejections found by each worker, indexed by numerator.
+  std::vector<size_t> *rejectedCounts;
+};
+
+typedef struct benjaminiHochbergStruct BHS;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Helper function to getBenjaminiHochbergThreshold() used with
+ * simple-thread-dispatch().  Feeds a share of an array, or of the rows
+ * of a matrix, to that worker's copy of the threshold finder.
+ **********************************************************************/
+void *benjaminiHochbergPassHelper(void *protoArgs);
+
+
+/*******************************************************************//**
+ * \brief Helper function to markBenjaminiHochbergRejections() used with
+ * simple-thread-dispatch().
+ **********************************************************************/
+void *benjaminiHochbergMarkHelper(void *protoArgs);
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//For doubles >= 0 the IEEE bit pattern orders like the value.
+static inline u64 bitsOf(cf64 value){
+  u64 tr;
+  memcpy(&tr, &value, sizeof(tr));
+  return tr;
+}
+
+
+static inline f64 valueOf(cu64 bits){
+  f64 tr;
+  memcpy(&tr, &bits, sizeof(tr));
+  return tr;
+}
+
+
+//Clamp into [0, 1], turning -0 into 0.  NaN must be filtered first.
+static inline f64 clampPValue(cf64 p){
+  return p > 0 ? (p < 1 ? p : 1) : 0;
+}
+
+
+//Rows of a matrix are dealt out round robin, since their lengths fall
+//off along the triangle.
+static void runMatrixRows(UpperDiagonalSquareMatrix<f64> &matrix,
+          csize_t numerator, csize_t denominator,
+                                  BenjaminiHochbergThreshold &part){
+  csize_t n = matrix.getSideLength();
+  for(size_t y = numerator; y + 1 < n; y += denominator){
+    std::pair<f64*, size_t> row = matrix.getRowSpan(y);
+    part.add(row.first + 1, row.second - 1);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+BenjaminiHochbergThreshold::BenjaminiHochbergThreshold(cf64 q,
+                        csize_t numBuckets, csize_t gatherLimit){
+  this->q = q;
+  this->numBuckets = numBuckets > 2 ? numBuckets : 2;
+  this->gatherLimit = gatherLimit;
+  m = 0;
+  firstPass = true;
+  gathering = false;
+  resolved = false;
+  threshold = -1;
+  lowBits = 0;
+  highBits = bitsOf(1.0) + 1;
+  belowCount = 0;
+}
+
+
+bool BenjaminiHochbergThreshold::isResolved() const{
+  return resolved;
+}
+
+
+void BenjaminiHochbergThreshold::beginPass(){
+  gathered.clear();
+  if(gathering) histogram.clear();
+  else histogram.assign(numBuckets, 0);
+}
+
+
+void BenjaminiHochbergThreshold::add(cf64 *pValues, csize_t count){
+  cu64 width = (highBits - lowBits + numBuckets - 1) / numBuckets;
+
+  for(size_t i = 0; i < count; i++){
+    if(isnan(pValues[i])) continue;
+    if(firstPass) m++;
+
+    cf64 p = clampPValue(pValues[i]);
+    cu64 bits = bitsOf(p);
+    if(bits < lowBits || bits >= highBits) continue;
+
+    if(gathering) gathered.push_back(p);
+    else histogram[(bits - lowBits) / width]++;
+  }
+}
+
+
+void BenjaminiHochbergThreshold::merge(
+                              const BenjaminiHochbergThreshold &other){
+  if(firstPass) m += other.m;
+  for(size_t j = 0; j < histogram.size() && j < other.histogram.size();
+                                                                    j++){
+    histogram[j] += other.histogram[j];
+  }
+  gathered.insert(gathered.end(), other.gathered.begin(),
+                                                  other.gathered.end());
+}
+
+
+void BenjaminiHochbergThreshold::endPass(){
+  if(gathering) resolveFromGathered();
+  else resolveFromHistogram();
+  firstPass = false;
+  histogram.clear();
+  histogram.shrink_to_fit();
+  gathered.clear();
+  gathered.shrink_to_fit();
+}
+
+
+void BenjaminiHochbergThreshold::resolveFromHistogram(){
+  if(0 == m){
+    resolved = true;
+    return;
+  }
+
+  cu64 width = (highBits - lowBits + numBuckets - 1) / numBuckets;
+
+  //A bucket may hold the cut off only if its cumulative count could
+  //reach its lower edge; its largest value surely passes if the count
+  //reaches its upper edge.  The cut off lies between the highest sure
+  //bucket, or failing that the lowest occupied one, and the highest
+  //possible one.
+  size_t cumulative = belowCount;
+  size_t first = 0, start = 0, startBelow = belowCount;
+  size_t end = 0, endBelow = 0, endCumulative = 0;
+  bool occupied = false, sure = false, possible = false;
+
+  for(size_t j = 0; j < histogram.size(); j++){
+    if(0 == histogram[j]) continue;
+    if(!occupied) first = j;
+    occupied = true;
+    cumulative += histogram[j];
+
+    cu64 bucketLow = lowBits + j * width;
+    cu64 bucketHigh = std::min(bucketLow + width, highBits);
+    cf64 reach = (f64) cumulative * q / m;
+
+    if(reach >= valueOf(bucketHigh)){
+      start = j;
+      startBelow = cumulative - histogram[j];
+      sure = true;
+    }
+    if(reach >= valueOf(bucketLow)){
+      end = j;
+      endBelow = cumulative - histogram[j];
+      endCumulative = cumulative;
+      possible = true;
+    }
+  }
+
+  if(!possible){
+    if(!resumeDeferred()) resolved = true;
+    return;
+  }
+
+  //Buckets of single values can be decided outright.
+  if(1 == width){
+    threshold = valueOf(lowBits + end);
+    resolved = true;
+    return;
+  }
+
+  if(!sure){
+    start = first;
+    startBelow = belowCount;
+  }
+
+  //If the buckets in doubt fill the whole range, nothing would narrow.
+  //Refine the highest alone then, keeping the rest for later.
+  cu64 newLowBits = lowBits + start * width;
+  cu64 newHighBits = std::min(lowBits + (end + 1) * width, highBits);
+  if(newLowBits == lowBits && newHighBits == highBits && start < end){
+    deferredRange rest;
+    rest.lowBits = newLowBits;
+    rest.highBits = lowBits + end * width;
+    rest.belowCount = startBelow;
+    rest.count = endBelow - startBelow;
+    deferred.push_back(rest);
+
+    lowBits = rest.highBits;
+    highBits = newHighBits;
+    belowCount = endBelow;
+    gathering = endCumulative - endBelow <= gatherLimit;
+    return;
+  }
+
+  lowBits = newLowBits;
+  highBits = newHighBits;
+  belowCount = startBelow;
+  gathering = endCumulative - startBelow <= gatherLimit;
+}
+
+
+void BenjaminiHochbergThreshold::resolveFromGathered(){
+  std::sort(gathered.begin(), gathered.end());
+
+  for(size_t i = 0; i < gathered.size(); i++){
+    //Only the last of a run of ties has the full count below it.
+    if(i + 1 < gathered.size() && gathered[i+1] == gathered[i]) continue;
+    if((f64) (belowCount + i + 1) * q / m >= gathered[i])
+      threshold = gathered[i];
+  }
+
+  if(threshold < 0 && resumeDeferred()) return;
+  resolved = true;
+}
+
+
+bool BenjaminiHochbergThreshold::resumeDeferred(){
+  if(deferred.empty()) return false;
+
+  lowBits = deferred.back().lowBits;
+  highBits = deferred.back().highBits;
+  belowCount = deferred.back().belowCount;
+  gathering = deferred.back().count <= gatherLimit;
+  deferred.pop_back();
+  return true;
+}
+
+
+f64 BenjaminiHochbergThreshold::getThreshold() const{
+  return threshold;
+}
+
+
+size_t BenjaminiHochbergThreshold::getNumberOfTests() const{
+  return m;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static f64 runBenjaminiHochberg(BHS &instructions, cf64 q){
+  BenjaminiHochbergThreshold tr(q);
+
+  while(!tr.isResolved()){
+    tr.beginPass();
+    csize_t numThreads = autoThreadCount();
+    std::vector<BenjaminiHochbergThreshold> parts(numThreads, tr);
+    instructions.parts = &parts;
+    autoThreadLauncher(benjaminiHochbergPassHelper, (void*) &instructions,
+                                                              numThreads);
+    for(size_t t = 0; t < parts.size(); t++) tr.merge(parts[t]);
+    tr.endPass();
+  }
+
+  return tr.getThreshold();
+}
+
+
+f64 getBenjaminiHochbergThreshold(cf64 *pValues, csize_t count, cf64 q){
+  BHS instructions;
+  memset(&instructions, 0, sizeof(instructions));
+  instructions.pValues = pValues;
+  instructions.count = count;
+  return runBenjaminiHochberg(instructions, q);
+}
+
+
+f64 getBenjaminiHochbergThreshold(
+                UpperDiagonalSquareMatrix<f64> &pValues, cf64 q){
+  BHS instructions;
+  memset(&instructions, 0, sizeof(instructions));
+  instructions.matrix = &pValues;
+  return runBenjaminiHochberg(instructions, q);
+}
+
+
+void *benjaminiHochbergPassHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  BHS *args = (BHS*) arg->specifics;
+  BenjaminiHochbergThreshold &part = (*args->parts)[numerator];
+
+  if(NULL != args->matrix){
+    runMatrixRows(*args->matrix, numerator, denominator, part);
+  }else{
+    csize_t minimum = (args->count * numerator) / denominator;
+    csize_t maximum = (args->count * (numerator+1)) / denominator;
+    part.add(args->pValues + minimum, maximum - minimum);
+  }
+
+  return NULL;
+}
+
+
+size_t markBenjaminiHochbergRejections(cf64 *pValues, csize_t count,
+                                      cf64 threshold, u8 *rejected){
+  csize_t numThreads = autoThreadCount();
+  std::vector<size_t> rejectedCounts(numThreads, 0);
+  BHS instructions;
+  memset(&instructions, 0, sizeof(instructions));
+  instructions.pValues = pValues;
+  instructions.count = count;
+  instructions.threshold = threshold;
+  instructions.rejected = rejected;
+  instructions.rejectedCounts = &rejectedCounts;
+
+  autoThreadLauncher(benjaminiHochbergMarkHelper, (void*) &instructions,
+                                                              numThreads);
+
+  size_t tr = 0;
+  for(size_t t = 0; t < rejectedCounts.size(); t++) tr += rejectedCounts[t];
+  return tr;
+}
+
+
+size_t markBenjaminiHochbergRejections(
+            UpperDiagonalSquareMatrix<f64> &pValues, cf64 threshold,
+                            UpperDiagonalSquareMatrix<u8> &rejected){
+  csize_t numThreads = autoThreadCount();
+  std::vector<size_t> rejectedCounts(numThreads, 0);
+  BHS instructions;
+  memset(&instructions, 0, sizeof(instructions));
+  instructions.matrix = &pValues;
+  instructions.threshold = threshold;
+  instructions.rejectedMatrix = &rejected;
+  instructions.rejectedCounts = &rejectedCounts;
+
+  autoThreadLauncher(benjaminiHochbergMarkHelper, (void*) &instructions,
+                                                              numThreads);
+
+  size_t tr = 0;
+  for(size_t t = 0; t < rejectedCounts.size(); t++) tr += rejectedCounts[t];
+  return tr;
+}
+
+
+void *benjaminiHochbergMarkHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  BHS *args = (BHS*) arg->specifics;
+  cf64 threshold = args->threshold;
+  size_t found = 0;
+
+  if(NULL != args->matrix){
+    csize_t n = args->matrix->getSideLength();
+    for(size_t y = numerator; y < n; y += denominator){
+      cf64 *row = args->matrix->getRowSpan(y).first;
+      u8 *flags = args->rejectedMatrix->getRowSpan(y).first;
+      flags[0] = 0;
+      for(size_t i = 1; i < n - y; i++){
+        flags[i] = row[i] <= threshold;
+        found += flags[i];
+      }
+    }
+  }else{
+    csize_t minimum = (args->count * numerator) / denominator;
+    csize_t maximum = (args->count * (numerator+1)) / denominator;
+    for(size_t i = minimum; i < maximum; i++){
+      args->rejected[i] = args->pValues[i] <= threshold;
+      found += args->rejected[i];
+    }
+  }
+
+  (*args->rejectedCounts)[numerator] = found;
+  return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,9 @@
 
 #include <rank-matrix.hpp>
 #include <correlation-matrix.hpp>
+#include <correlation-path-selector.hpp>
+#include <parallel-control.hpp>
+#include <parallel-profile.hpp>
 #include <simple-thread-dispatch.hpp>
 #include <timsort.hpp>
 #include <upper-diagonal-square-matrix.hpp>
@@ -107,7 +110,7 @@ void *tauCorrelationHelperCrossReference(void *protoArgs){
   csize_t maximum = (numTFs * (numerator+1)) / denominator;
 
 
-  for(size_t y = minimum; y < maximum; y++){
+  for(size_t y = minimum; y < maximum && !parallelCancelled(); y++){
     for(size_t x = 0; x < numGenes; x++){
       ssize_t coordinateDisccordinatePairTally = 0;
       for(size_t i = 0; i < corrVecLeng; i++){
@@ -120,6 +123,7 @@ void *tauCorrelationHelperCrossReference(void *protoArgs){
       (*results)[y][x] = ((f64) coordinateDisccordinatePairTally) /
                       (corrVecLeng*(corrVecLeng-1));
     }
+    reportParallelProgress(1);
   }
 
   return NULL;
@@ -135,7 +139,6 @@ void *tauCorrelationHelperBruteForce(void *protoArgs){
   TCHSBF *args = (TCHSBF*) arg->specifics;
 
   std::vector<std::vector<double> > *expressionData = args->expressionData;
-  csize_t numRows = (*expressionData).size();
   csize_t numCols = (*expressionData)[0].size();
 
   UpperDiagonalSquareMatrix<f64> *results = args->results;
@@ -145,57 +148,65 @@ void *tauCorrelationHelperBruteForce(void *protoArgs){
   csize_t maximum = (results->numberOfElements() * (numerator+1))
                                                           / denominator;
 
+  if(minimum >= maximum) return NULL;
   std::pair<size_t, size_t> startXY = results->WtoXY(minimum);
-  std::pair<size_t, size_t> endXY = results->WtoXY(maximum);
-  csize_t tmpSY = startXY.second;
-
-  for(size_t x = startXY.first; x < numRows; x++){
-    ssize_t coordinateDisccordinatePairTally = 0;
-    for(size_t i = 0; i < numCols; i++){
-        double left = (*expressionData)[x][i];
-        double right = (*expressionData)[tmpSY][i];
-        coordinateDisccordinatePairTally += left == right ? 1 : -1;
+  UpperDiagonalSquareMatrix<f64>::cursor at =
+                        results->cursorAt(startXY.first, startXY.second);
+
+  //Each row start is a tile boundary for cancelling and progress.
+  size_t reported = minimum;
+  size_t w;
+  for(w = minimum; w < maximum; w++, ++at){
+    csize_t x = at.x();
+    csize_t y = at.y();
+    if(x == y){
+      reportParallelProgress(w - reported);
+      reported = w;
+      if(parallelCancelled()) break;
+      *at = 1.0;
+      continue;
     }
-    coordinateDisccordinatePairTally *= 2;
-    f64 result = ((f64) coordinateDisccordinatePairTally) /
-                                          (numCols*(numCols-1));
-    results->setValueAtIndex(x, tmpSY, result);
-  }
 
-  for(size_t y = startXY.second+1; y < endXY.second; y++){
-    results->setValueAtIndex(y, y, 1.0);
-    for(size_t x = y+1; x < numRows; x++){
-      ssize_t coordinateDisccordinatePairTally = 0;
-      for(size_t i = 0; i < numCols; i++){
-        double left = (*expressionData)[x][i];
-        double right = (*expressionData)[y][i];
-        coordinateDisccordinatePairTally += left == right ? 1 : -1;
-      }
-      coordinateDisccordinatePairTally *= 2;
-      f64 result = ((f64) coordinateDisccordinatePairTally) /
-                                          (numCols*(numCols-1));
-      results->setValueAtIndex(x, y, result);
-    }
-  }
-
-  csize_t tmpEY = endXY.second;
-  for(size_t x = tmpEY; x < endXY.first; x++){
     ssize_t coordinateDisccordinatePairTally = 0;
     for(size_t i = 0; i < numCols; i++){
         double left = (*expressionData)[x][i];
-        double right = (*expressionData)[tmpEY][i];
+        double right = (*expressionData)[y][i];
         coordinateDisccordinatePairTally += left == right ? 1 : -1;
     }
     coordinateDisccordinatePairTally *= 2;
-    f64 result = ((f64) coordinateDisccordinatePairTally) /
-                                          (numCols*(numCols-1));
-    results->setValueAtIndex(x, tmpEY, result);
+    *at = ((f64) coordinateDisccordinatePairTally) / (numCols*(numCols-1));
   }
+  reportParallelProgress(w - reported);
 
   return NULL;
 }
 
 
+extern UpperDiagonalSquareMatrix<f64>
+calculateKendallsTauCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData)
+{
+  UpperDiagonalSquareMatrix<f64> tr(expressionData->size());
+  //Touch the triangle with the same split the helper uses.
+  tr.zeroData();
+
+  calculateRankMatrix(*expressionData);
+
+  TCHSBF instructions = {
+      expressionData,
+      &tr
+    };
+
+  ParallelRegion region("kendall brute force");
+  beginParallelProgress(tr.numberOfElements());
+  autoThreadLauncher(tauCorrelationHelperBruteForce, (void*) &instructions);
+
+  if(parallelCancelled()) return UpperDiagonalSquareMatrix<f64>();
+
+  return tr;
+}
+
+
 extern std::vector<std::vector<double> >
 calculateKendallsTauCorrelationCorrelationMatrix(
   std::vector<std::vector<double> > *expressionData,
@@ -208,15 +219,19 @@ calculateKendallsTauCorrelationCorrelationMatrix(
   //}else{
     rankedMatrix = expressionData;
   //}
-  void *tmpPtr;
   csize_t numRows = (*rankedMatrix).size();
-
-
-  calculateRankMatrix(*rankedMatrix);
-
-  //just calculate everything
-  if( NULL == againstRows || numRows/2 < againstRows->size()){
-    for(size_t i = 0; i < againstRows->size(); i++){
+  csize_t numCols = numRows > 0 ? (*rankedMatrix)[0].size() : 0;
+  csize_t againstRowsLength = NULL == againstRows ? numRows
+                                                  : againstRows->size();
+
+  //only calculate things we need
+  if(NULL != againstRows && CORRELATION_PATH_CROSS_REFERENCE ==
+                  selectCorrelationPath(CORRELATION_KERNEL_KENDALL, numRows,
+                            numCols, againstRowsLength, autoThreadCount())){
+    calculateRankMatrix(*rankedMatrix);
+
+    tr.reserve(againstRowsLength);
+    for(size_t i = 0; i < againstRowsLength; i++){
       tr.push_back(std::vector<double>(numRows));
     }
 
@@ -226,57 +241,48 @@ calculateKendallsTauCorrelationCorrelationMatrix(
         &tr
       };
 
+    ParallelRegion region("kendall cross reference");
+    beginParallelProgress(againstRowsLength);
     autoThreadLauncher(tauCorrelationHelperCrossReference,
                                                 (void*) &instructions);
+    if(parallelCancelled()) tr.clear();
 
-  }else{//only calculate things we need
+  }else{//just calculate everything
 
-    UpperDiagonalSquareMatrix<double> *corrMatr;
-    corrMatr = new UpperDiagonalSquareMatrix<double>(numRows);
-
-    TCHSBF instructions = {
-        rankedMatrix,
-        corrMatr
-      };
-
-    autoThreadLauncher(tauCorrelationHelperBruteForce,
-                                                (void*) &instructions);
-
-    if(NULL == againstRows){
-      tr.reserve(numRows);
-      for(size_t i = 0; i < numRows; i++){
-        tr.push_back(std::vector<double>(numRows));
-      }
-
-      for(size_t y = 0; y < numRows; y++){
-        tr[y][y] = 1.0;
-        for(size_t x = y+1; x < numRows; x++){
-          tr[y][x] = tr[x][y] = corrMatr->getValueAtIndex(x, y);
-        }
-      }
-
-    }else{
-      tr.reserve(againstRows->size());
-      for(size_t i = 0; i < againstRows->size(); i++){
-        tr.push_back(std::vector<double>(numRows));
-      }
-
-      for(size_t yPrime = 0; yPrime < againstRows->size(); yPrime++){
-        csize_t y = (*againstRows)[yPrime];
-        for(size_t x = 0; x < numRows; x++){
-          tr[yPrime][x] = corrMatr->getValueAtIndex(x, y);
-        }
-      }
+    UpperDiagonalSquareMatrix<f64> corrMatr =
+                    calculateKendallsTauCorrelationTriangle(rankedMatrix);
+    if(parallelCancelled()) return tr;
 
+    tr.reserve(againstRowsLength);
+    for(size_t i = 0; i < againstRowsLength; i++){
+      tr.push_back(std::vector<double>(numRows));
     }
 
-    delete corrMatr;
+    for(size_t yPrime = 0; yPrime < againstRowsLength; yPrime++){
+      corrMatr.getRow(NULL == againstRows ? yPrime
+                          : (*againstRows)[yPrime], tr[yPrime].data());
+    }
   }
 
   return tr;
 }
 
 
+extern AsyncResult<std::vector<std::vector<double> > >
+calculateKendallsTauCorrelationCorrelationMatrixAsync(
+  std::vector<std::vector<double> > *expressionData,
+  const std::vector<size_t> *againstRows,
+  CancellationToken *token,
+  parallelProgressCallback progress,
+  void *context)
+{
+  return runAsync<std::vector<std::vector<double> > >([=]{
+    return calculateKendallsTauCorrelationCorrelationMatrix(expressionData,
+                                                            againstRows);
+  }, token, progress, context);
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,101 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <large-allocation.hpp>
+#include <parallel-for.hpp>
+#include <parallel-profile.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE CONSTANTS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static csize_t HUGE_PAGE_SIZE = 2 << 20;
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+bool hugePagesEnabled(){
+  static const bool enabled = []{
+    const char *setting = getenv("MADLIB_HUGE_PAGES");
+    return NULL == setting || 0 != strcmp(setting, "0");
+  }();
+  return enabled;
+}
+
+
+void *allocateLarge(csize_t size){
+  if(size < HUGE_PAGE_SIZE || !hugePagesEnabled()) return malloc(size);
+
+  void *tr;
+  csize_t rounded = ((size + HUGE_PAGE_SIZE-1) / HUGE_PAGE_SIZE)
+                                                      * HUGE_PAGE_SIZE;
+  if(0 != posix_memalign(&tr, HUGE_PAGE_SIZE, rounded)) return NULL;
+
+  #ifdef MADV_HUGEPAGE
+  //Only advice; without transparent huge pages this fails harmlessly.
+  madvise(tr, rounded, MADV_HUGEPAGE);
+  #endif
+
+  return tr;
+}
+
+
+void firstTouchZero(void *memory, csize_t size){
+  if(size < HUGE_PAGE_SIZE){
+    memset(memory, 0, size);
+    return;
+  }
+
+  u8 *bytes = (u8*) memory;
+  ParallelRegion region("first touch");
+  parallelFor(0, size, 0, [bytes](csize_t first, csize_t last){
+    memset(bytes + first, 0, last - first);
+  });
+}
+
+
+void distributeRows(std::vector<std::vector<double> > &data){
+  //Each copy is allocated and written by the worker owning the row, so
+  //its pages are first touched there.
+  parallelFor(0, data.size(), 0, [&data](csize_t first, csize_t last){
+    for(size_t y = first; y < last; y++){
+      std::vector<double> local(data[y]);
+      data[y].swap(local);
+    }
+  });
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,242 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <limits>
+
+#include <online-statistics.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE CONSTANTS/////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static cf64 NOT_A_NUMBER = std::numeric_limits<f64>::quiet_NaN();
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+OnlineMoments::OnlineMoments(){
+  count = nanCount = 0;
+  mean = m2 = m3 = m4 = 0;
+  minimum = std::numeric_limits<f64>::infinity();
+  maximum = -minimum;
+}
+
+
+void OnlineMoments::push(cf64 value){
+  if(std::isnan(value)){
+    nanCount++;
+    return;
+  }
+
+  //Update the higher moments first; each uses the previous lower ones.
+  cf64 n1 = count;
+  cf64 n = ++count;
+  cf64 delta = value - mean;
+  cf64 deltaN = delta / n;
+  cf64 deltaN2 = deltaN * deltaN;
+  cf64 term = delta * deltaN * n1;
+  mean += deltaN;
+  m4 += term * deltaN2 * (n*n - 3*n + 3) + 6 * deltaN2 * m2
+                                                      - 4 * deltaN * m3;
+  m3 += term * deltaN * (n - 2) - 3 * deltaN * m2;
+  m2 += term;
+
+  if(value < minimum) minimum = value;
+  if(value > maximum) maximum = value;
+}
+
+
+void OnlineMoments::push(cf64 *array, csize_t size){
+  for(size_t i = 0; i < size; i++) push(array[i]);
+}
+
+
+void OnlineMoments::merge(const OnlineMoments &other){
+  nanCount += other.nanCount;
+  if(0 == other.count) return;
+  if(0 == count){
+    csize_t nans = nanCount;
+    *this = other;
+    nanCount = nans;
+    return;
+  }
+
+  cf64 na = count, nb = other.count;
+  cf64 n = na + nb;
+  cf64 delta = other.mean - mean;
+  cf64 delta2 = delta * delta;
+  cf64 delta3 = delta2 * delta;
+  cf64 delta4 = delta2 * delta2;
+
+  cf64 mergedM4 = m4 + other.m4
+          + delta4 * na * nb * (na*na - na*nb + nb*nb) / (n * n * n)
+          + 6 * delta2 * (na*na * other.m2 + nb*nb * m2) / (n * n)
+          + 4 * delta * (na * other.m3 - nb * m3) / n;
+  cf64 mergedM3 = m3 + other.m3
+          + delta3 * na * nb * (na - nb) / (n * n)
+          + 3 * delta * (na * other.m2 - nb * m2) / n;
+
+  m4 = mergedM4;
+  m3 = mergedM3;
+  m2 += other.m2 + delta2 * na * nb / n;
+  mean += delta * nb / n;
+  count += other.count;
+
+  if(other.minimum < minimum) minimum = other.minimum;
+  if(other.maximum > maximum) maximum = other.maximum;
+}
+
+
+size_t OnlineMoments::getCount() const{
+  return count;
+}
+
+
+size_t OnlineMoments::getNanCount() const{
+  return nanCount;
+}
+
+
+f64 OnlineMoments::getMean() const{
+  return count > 0 ? mean : NOT_A_NUMBER;
+}
+
+
+f64 OnlineMoments::getVariance() const{
+  return count > 1 ? m2 / (count - 1) : NOT_A_NUMBER;
+}
+
+
+f64 OnlineMoments::getSkewness() const{
+  return m2 > 0 ? sqrt((f64) count) * m3 / pow(m2, 1.5) : NOT_A_NUMBER;
+}
+
+
+f64 OnlineMoments::getKurtosis() const{
+  return m2 > 0 ? count * m4 / (m2 * m2) - 3 : NOT_A_NUMBER;
+}
+
+
+f64 OnlineMoments::getMinimum() const{
+  return count > 0 ? minimum : NOT_A_NUMBER;
+}
+
+
+f64 OnlineMoments::getMaximum() const{
+  return count > 0 ? maximum : NOT_A_NUMBER;
+}
+
+
+f64 OnlineMoments::getSecondMoment() const{
+  return m2;
+}
+
+
+OnlineCovariance::OnlineCovariance(){
+  count = 0;
+  meanX = meanY = m2X = m2Y = coMoment = 0;
+}
+
+
+void OnlineCovariance::push(cf64 x, cf64 y){
+  if(std::isnan(x) || std::isnan(y)) return;
+
+  cf64 n = ++count;
+  cf64 deltaX = x - meanX;
+  cf64 deltaY = y - meanY;
+  meanX += deltaX / n;
+  meanY += deltaY / n;
+  //Mixing the old and new deviations gives the exact increment.
+  m2X += deltaX * (x - meanX);
+  m2Y += deltaY * (y - meanY);
+  coMoment += deltaX * (y - meanY);
+}
+
+
+void OnlineCovariance::push(cf64 *x, cf64 *y, csize_t size){
+  for(size_t i = 0; i < size; i++) push(x[i], y[i]);
+}
+
+
+void OnlineCovariance::merge(const OnlineCovariance &other){
+  if(0 == other.count) return;
+  if(0 == count){
+    *this = other;
+    return;
+  }
+
+  cf64 na = count, nb = other.count;
+  cf64 n = na + nb;
+  cf64 deltaX = other.meanX - meanX;
+  cf64 deltaY = other.meanY - meanY;
+  cf64 weight = na * nb / n;
+
+  m2X += other.m2X + deltaX * deltaX * weight;
+  m2Y += other.m2Y + deltaY * deltaY * weight;
+  coMoment += other.coMoment + deltaX * deltaY * weight;
+  meanX += deltaX * nb / n;
+  meanY += deltaY * nb / n;
+  count += other.count;
+}
+
+
+size_t OnlineCovariance::getCount() const{
+  return count;
+}
+
+
+f64 OnlineCovariance::getMeanX() const{
+  return count > 0 ? meanX : NOT_A_NUMBER;
+}
+
+
+f64 OnlineCovariance::getMeanY() const{
+  return count > 0 ? meanY : NOT_A_NUMBER;
+}
+
+
+f64 OnlineCovariance::getCoMoment() const{
+  return coMoment;
+}
+
+
+f64 OnlineCovariance::getCovariance() const{
+  return count > 1 ? coMoment / (count - 1) : NOT_A_NUMBER;
+}
+
+
+f64 OnlineCovariance::getCorrelation() const{
+  return m2X > 0 && m2Y > 0 ? coMoment / sqrt(m2X * m2Y) : NOT_A_NUMBER;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
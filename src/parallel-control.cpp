@@ -0,0 +1,137 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <parallel-control.hpp>
+#include <parallel-profile.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STATE/////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static thread_local ParallelControl *activeControl = NULL;
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+CancellationToken::CancellationToken(){
+  cancelled = false;
+}
+
+
+void CancellationToken::cancel(){
+  cancelled.store(true, std::memory_order_relaxed);
+}
+
+
+bool CancellationToken::isCancelled() const{
+  return cancelled.load(std::memory_order_relaxed);
+}
+
+
+void CancellationToken::reset(){
+  cancelled = false;
+}
+
+
+ParallelControl::ParallelControl(CancellationToken *token,
+              parallelProgressCallback callback, void *context){
+  this->token = token;
+  this->callback = callback;
+  this->context = context;
+  stage = NULL;
+  total = 0;
+  completed = 0;
+  previous = swapParallelControl(this);
+}
+
+
+ParallelControl::~ParallelControl(){
+  swapParallelControl(previous);
+}
+
+
+bool ParallelControl::isCancelled() const{
+  return NULL != token && token->isCancelled();
+}
+
+
+void ParallelControl::beginProgress(const char *stage, csize_t total){
+  std::lock_guard<std::mutex> guard(progressLock);
+  this->stage = stage;
+  this->total = total;
+  completed = 0;
+  if(NULL != callback) callback(stage, 0, total, context);
+}
+
+
+void ParallelControl::addProgress(csize_t amount){
+  completed += amount;
+  if(NULL == callback) return;
+
+  //Read the count under the lock so reports never go backwards.
+  std::lock_guard<std::mutex> guard(progressLock);
+  callback(stage, completed.load(), total, context);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+bool parallelCancelled(){
+  return NULL != activeControl && activeControl->isCancelled();
+}
+
+
+void beginParallelProgress(csize_t total){
+  if(NULL != activeControl)
+    activeControl->beginProgress(currentParallelRegion(), total);
+}
+
+
+void reportParallelProgress(csize_t amount){
+  if(NULL != activeControl && amount > 0) activeControl->addProgress(amount);
+}
+
+
+ParallelControl *currentParallelControl(){
+  return activeControl;
+}
+
+
+ParallelControl *swapParallelControl(ParallelControl *control){
+  ParallelControl *tr = activeControl;
+  activeControl = control;
+  return tr;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
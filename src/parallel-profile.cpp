@@ -0,0 +1,214 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parallel-profile.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STATE/////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static const char *UNNAMED_REGION = "unnamed";
+
+static std::mutex recordsLock;
+static std::map<std::string, parallelRegionProfile> records;
+
+static thread_local const char *regionName = NULL;
+static thread_local u64 *shareItems = NULL;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static void printParallelProfileAtExit(){
+  printParallelProfile(stderr);
+}
+
+
+//Read MADLIB_PROFILE once; the flag may then be changed freely.
+static std::atomic<bool>& profilingFlag(){
+  static std::atomic<bool> flag([]{
+    const char *setting = getenv("MADLIB_PROFILE");
+    if(NULL == setting || 0 == strcmp(setting, "0")) return false;
+    atexit(printParallelProfileAtExit);
+    return true;
+  }());
+  return flag;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+ParallelRegion::ParallelRegion(const char *name){
+  previous = regionName;
+  regionName = name;
+}
+
+
+ParallelRegion::~ParallelRegion(){
+  regionName = previous;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+bool parallelProfilingEnabled(){
+  return profilingFlag().load(std::memory_order_relaxed);
+}
+
+
+void setParallelProfiling(const bool enabled){
+  profilingFlag() = enabled;
+}
+
+
+const char *currentParallelRegion(){
+  return NULL == regionName ? UNNAMED_REGION : regionName;
+}
+
+
+void countParallelItems(csize_t count){
+  if(NULL != shareItems) *shareItems += count;
+}
+
+
+f64 parallelProfileClock(){
+  return std::chrono::duration<f64>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+size_t parallelProfileThreadSlot(){
+  static std::atomic<size_t> nextSlot(0);
+  static thread_local size_t slot = nextSlot++;
+  return slot;
+}
+
+
+void *profiledShare(void *protoArgs){
+  profiledLoad *share = (profiledLoad*) protoArgs;
+
+  //Nested launches from this share are recorded under the same region.
+  const char *previousRegion = regionName;
+  u64 *previousItems = shareItems;
+  regionName = share->region;
+  shareItems = &share->items;
+
+  cf64 start = parallelProfileClock();
+  share->func((void*) share->load);
+  share->busySeconds = parallelProfileClock() - start;
+
+  regionName = previousRegion;
+  shareItems = previousItems;
+  return NULL;
+}
+
+
+void recordParallelRegion(const char *name, cf64 wallSeconds,
+      const std::vector<f64> &busySeconds, const std::vector<u64> &items){
+  std::lock_guard<std::mutex> guard(recordsLock);
+  parallelRegionProfile &record = records[name];
+
+  if(0 == record.launches) record.name = name;
+  record.launches++;
+  record.wallSeconds += wallSeconds;
+
+  if(record.busySeconds.size() < busySeconds.size()){
+    record.busySeconds.resize(busySeconds.size(), 0);
+    record.items.resize(busySeconds.size(), 0);
+  }
+  for(size_t i = 0; i < busySeconds.size(); i++){
+    record.busySeconds[i] += busySeconds[i];
+    record.items[i] += i < items.size() ? items[i] : 0;
+  }
+}
+
+
+std::vector<parallelRegionProfile> getParallelProfile(){
+  std::vector<parallelRegionProfile> tr;
+  {
+    std::lock_guard<std::mutex> guard(recordsLock);
+    for(auto it = records.begin(); it != records.end(); ++it)
+      tr.push_back(it->second);
+  }
+
+  std::sort(tr.begin(), tr.end(), [](const parallelRegionProfile &left,
+                                    const parallelRegionProfile &right){
+    return left.wallSeconds > right.wallSeconds;
+  });
+  return tr;
+}
+
+
+void resetParallelProfile(){
+  std::lock_guard<std::mutex> guard(recordsLock);
+  records.clear();
+}
+
+
+void printParallelProfile(FILE *stream){
+  std::vector<parallelRegionProfile> profile = getParallelProfile();
+
+  fprintf(stream, "%-32s %8s %10s %10s %6s %9s %10s %12s\n", "region",
+          "launches", "wall(s)", "busy(s)", "shares", "imbalance",
+                                                "efficiency", "items");
+  for(size_t r = 0; r < profile.size(); r++){
+    const parallelRegionProfile &region = profile[r];
+    csize_t shares = region.busySeconds.size();
+    f64 busy = 0, busiest = 0;
+    u64 items = 0;
+    for(size_t i = 0; i < shares; i++){
+      busy += region.busySeconds[i];
+      busiest = std::max(busiest, region.busySeconds[i]);
+      items += region.items[i];
+    }
+
+    cf64 imbalance = busy > 0 ? busiest * shares / busy : 1;
+    cf64 efficiency = region.wallSeconds > 0 && shares > 0
+                          ? busy / (region.wallSeconds * shares) : 1;
+    fprintf(stream, "%-32s %8zu %10.4f %10.4f %6zu %9.3f %10.3f %12llu\n",
+        region.name.c_str(), region.launches, region.wallSeconds, busy,
+                shares, imbalance, efficiency, (unsigned long long) items);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
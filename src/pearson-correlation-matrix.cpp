@@ -24,9 +24,19 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <atomic>
+#include <string>
 #include <vector>
 
+#include <correlation-checkpoint.hpp>
 #include <correlation-matrix.hpp>
+#include <correlation-path-selector.hpp>
+#include <parallel-control.hpp>
+#include <parallel-for.hpp>
+#include <parallel-profile.hpp>
+#include <rank-matrix.hpp>
+#include <task-graph.hpp>
 #include <timsort.hpp>
 #include <simple-thread-dispatch.hpp>
 #include <statistics.hpp>
@@ -65,13 +75,19 @@ struct rankHelpStruct{
 typedef struct rankHelpStruct RHS;
 
 
-struct CAPHStruct{
-    const std::vector<std::vector<double> > *expressionData;
+struct corrHelpStructCheckpoint{
+  std::vector<double> *sumsOfSquares;
+  std::vector<std::vector<double> > *expressionData;
+  const std::vector<u8> *rowRequested;
+  const std::vector<std::vector<size_t> > *resultRowsFor;
+  CorrelationCheckpoint *checkpoint;
+  std::atomic<size_t> *nextTile;
+  std::atomic<bool> *failed;
 
-    std::vector<double> *sumsOfSquares;
+  std::vector<std::vector<double> > *results;
 };
 
-typedef struct CAPHStruct CAPHS;
+typedef struct corrHelpStructCheckpoint CHSCK;
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -92,11 +108,13 @@ void *correlationHelperCrossReference(void *protoArgs);
 void *correlationHelperBruteForce(void *protoArgs);
 
 
-/***********************************************************************
- * \brief Helper function to centerAndPrecompute() used with
- * simple-thread-dispatch().
+/*******************************************************************//**
+ * \brief Helper function to
+ * calculatePearsonCorrelationMatrixCheckpointed() used with
+ * simple-thread-dispatch().  Workers claim tiles one at a time until
+ * none remain.
  **********************************************************************/
-void *centerAndPrecomputeHelper(void *protoArgs);
+void *correlationHelperCheckpoint(void *protoArgs);
 
 
 //void *rankHelper(void *protoArgs);
@@ -106,44 +124,26 @@ void *centerAndPrecomputeHelper(void *protoArgs);
 //FUNCTION DEFINITIONS//////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-std::vector<double> centerAndPrecomputeSquares(const std::vector<std::vector<double> > &expressionData){
+std::vector<double> centerAndPrecomputeSquares(std::vector<std::vector<double> > &expressionData){
   std::vector<double> tr(expressionData.size());
-
-  CAPHS instructions = {
-      &expressionData,
-      &tr
-    };
-
-  autoThreadLauncher(centerAndPrecomputeHelper, (void*) &instructions);
+  csize_t numCols = expressionData.size() > 0 ? expressionData[0].size()
+                                              : 0;
+
+  //The cross sums are only correlations once every row is centered, so
+  //center in place rather than on a copy.
+  ParallelRegion region("pearson center");
+  parallelFor(0, expressionData.size(), 0,
+                              [&](csize_t first, csize_t last){
+    for(size_t i = first; i < last; i++){
+      inplaceCenterMean(expressionData[i].data(), numCols);
+      tr[i] = getSumOfSquares(expressionData[i].data(), numCols);
+    }
+  });
 
   return tr;
 }
 
 
-void *centerAndPrecomputeHelper(void *protoArg){
-  struct multithreadLoad *arg = (struct multithreadLoad*) protoArg;
-  csize_t denominator = arg->denominator;
-  csize_t numerator = arg->numerator;
-
-  CAPHS *args = (CAPHS*) arg->specifics;
-  const std::vector<std::vector<double> > *expressionData = args->expressionData;
-  csize_t numRows = (*expressionData).size();
-  csize_t numCols = (*expressionData)[0].size();
-  std::vector<double> *sumsOfSquares = args->sumsOfSquares;
-
-  csize_t minimum = (numRows * numerator) / denominator;
-  csize_t maximum = (numRows * (numerator+1)) / denominator;
-
-  for(size_t i = minimum; i < maximum; i++){
-    f64* tmpVec = centerMean((*expressionData)[i].data(), numCols);
-    (*sumsOfSquares)[i] = getSumOfSquares(tmpVec, numCols);
-    free(tmpVec);
-  }
-
-  return NULL;
-}
-
-
 void *correlationHelperCrossReference(void *protoArgs){
 
   struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
@@ -168,14 +168,24 @@ void *correlationHelperCrossReference(void *protoArgs){
   csize_t minimum = (againstRowsLength * numerator) / denominator;
   csize_t maximum = (againstRowsLength * (numerator+1)) / denominator;
 
-  for(size_t y = minimum; y < maximum; y++){
+  pinnedSumsOfMultipliedArraysFunction crossSums =
+                        selectPinnedSumsOfMultipliedArrays(corrVecLeng);
+  std::vector<cf64*> rowPointers(numGenes);
+  for(size_t x = 0; x < numGenes; x++)
+    rowPointers[x] = (*geneCorrData)[x].data();
+
+  for(size_t y = minimum; y < maximum && !parallelCancelled(); y++){
+    csize_t pinnedRow = (*againstRows)[y];
+    f64 *resultRow = (*results)[y].data();
+    crossSums(rowPointers[pinnedRow], rowPointers.data(), numGenes,
+                                              corrVecLeng, resultRow);
     for(size_t x = 0; x < numGenes; x++){
-      cf64 abCrossSum = getSumOfMultipliedArrays((*geneCorrData)[x].data(),
-                              (*geneCorrData)[(*againstRows)[y]].data(), corrVecLeng);
-      (*results)[y][x] = getCenteredCorrelationBasic((*sumsOfSquares)[x],
-                              (*sumsOfSquares)[(*againstRows)[y]], abCrossSum);
+      resultRow[x] = getCenteredCorrelationBasic((*sumsOfSquares)[x],
+                            (*sumsOfSquares)[pinnedRow], resultRow[x]);
     }
+    reportParallelProgress(1);
   }
+  countParallelItems((maximum - minimum) * numGenes);
 
   return NULL;
 }
@@ -203,39 +213,151 @@ void *correlationHelperBruteForce(void *protoArgs){
   csize_t maximum = (results->numberOfElements() * (numerator+1))
                                                           / denominator;
 
-  //TODO: optimize index calculation by moving x and y into their own
-  //loops and just use the WToXY to establish start and end.  Also
-  //include primer loops
+  pinnedSumsOfMultipliedArraysFunction crossSums =
+                        selectPinnedSumsOfMultipliedArrays(corrVecLeng);
+  std::vector<cf64*> rowPointers(numGenes);
+  for(size_t x = 0; x < numGenes; x++)
+    rowPointers[x] = (*geneCorrData)[x].data();
+  std::vector<f64> rowCrossSums(numGenes);
+
+  //This worker's share starts part way along one row and ends part way
+  //along another; locate the start once, then fill whole row spans.
+  if(minimum >= maximum) return NULL;
   std::pair<size_t, size_t> startXY = results->WtoXY(minimum);
-  std::pair<size_t, size_t> endXY = results->WtoXY(maximum);
-  csize_t tmpSY = startXY.second;
-
-  for(size_t x = startXY.first; x < numGenes; x++){
-    cf64 abCrossSum = getSumOfMultipliedArrays((*geneCorrData)[x].data(),
-                                      (*geneCorrData)[tmpSY].data(), corrVecLeng);
-    results->setValueAtIndex(x, tmpSY, getCenteredCorrelationBasic(
-                  (*sumsOfSquares)[x], (*sumsOfSquares)[tmpSY], abCrossSum));
-  }
+  size_t remaining = maximum - minimum;
+
+  for(size_t y = startXY.second, x = startXY.first; remaining > 0;
+                                                            y++, x = y){
+    if(parallelCancelled()) break;
+    f64 *row = results->getRowSpan(y).first;
+    csize_t end = std::min(numGenes, x + remaining);
+    csize_t spanLength = end - x;
+    remaining -= spanLength;
+
+    if(x == y){
+      row[0] = 1.0;
+      x++;
+    }
 
-  for(size_t y = startXY.second+1; y < endXY.second; y++){
-    results->setValueAtIndex(y, y, 1.0);
-    for(size_t x = y+1; x < numGenes; x++){
-      cf64 abCrossSum = getSumOfMultipliedArrays((*geneCorrData)[x].data(),
-                                      (*geneCorrData)[y].data(), corrVecLeng);
-      results->setValueAtIndex(x, y, getCenteredCorrelationBasic(
-                    (*sumsOfSquares)[x], (*sumsOfSquares)[y], abCrossSum));
+    crossSums(rowPointers[y], rowPointers.data() + x, end - x,
+                                      corrVecLeng, rowCrossSums.data());
+    for(size_t i = x; i < end; i++){
+      row[i - y] = getCenteredCorrelationBasic((*sumsOfSquares)[i],
+                      (*sumsOfSquares)[y], rowCrossSums[i - x]);
     }
+    reportParallelProgress(spanLength);
+  }
+  countParallelItems(maximum - minimum);
+
+  return NULL;
+}
+
+
+UpperDiagonalSquareMatrix<f64> calculatePearsonCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData)
+{
+  std::vector<double> sumsOfSquares;
+  UpperDiagonalSquareMatrix<f64> tr(expressionData->size());
+  //Touch the triangle with the same split the helper uses.
+  tr.zeroData();
+
+  sumsOfSquares = centerAndPrecomputeSquares(*expressionData);
+
+  CHSBF instructions = {
+    &sumsOfSquares,
+    expressionData,
+
+    &tr
+  };
+
+  ParallelRegion region("pearson brute force");
+  beginParallelProgress(tr.numberOfElements());
+  autoThreadLauncher(correlationHelperBruteForce, (void*) &instructions);
+
+  if(parallelCancelled()) return UpperDiagonalSquareMatrix<f64>();
+
+  return tr;
+}
+
+
+UpperDiagonalSquareMatrix<f64> calculatePipelinedCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData, const bool rankRows,
+  csize_t blockSize)
+{
+  std::vector<std::vector<double> > &data = *expressionData;
+  csize_t numRows = data.size();
+  csize_t numCols = numRows > 0 ? data[0].size() : 0;
+  csize_t step = blockSize > 0 ? blockSize : 1;
+  csize_t numBlocks = (numRows + step-1) / step;
+
+  std::vector<double> sumsOfSquares(numRows);
+  UpperDiagonalSquareMatrix<f64> tr(numRows);
+
+  pinnedSumsOfMultipliedArraysFunction crossSums =
+                              selectPinnedSumsOfMultipliedArrays(numCols);
+  std::vector<cf64*> rowPointers(numRows);
+  for(size_t x = 0; x < numRows; x++)
+    rowPointers[x] = data[x].data();
+
+  TaskGraph graph;
+  std::vector<size_t> prepared(numBlocks);
+
+  for(size_t b = 0; b < numBlocks; b++){
+    csize_t first = b * step;
+    csize_t last = std::min(first + step, numRows);
+    prepared[b] = graph.addTask([&, first, last]{
+      if(parallelCancelled()) return;
+      if(rankRows) calculateRankRows(data, first, last);
+      for(size_t i = first; i < last; i++){
+        inplaceCenterMean(data[i].data(), numCols);
+        sumsOfSquares[i] = getSumOfSquares(data[i].data(), numCols);
+      }
+    });
   }
 
-  csize_t tmpEY = endXY.second;
-    for(size_t x = tmpEY; x < endXY.first; x++){
-    cf64 abCrossSum = getSumOfMultipliedArrays((*geneCorrData)[x].data(),
-                                      (*geneCorrData)[tmpEY].data(), corrVecLeng);
-    results->setValueAtIndex(x, tmpEY, getCenteredCorrelationBasic(
-                  (*sumsOfSquares)[x], (*sumsOfSquares)[tmpEY], abCrossSum));
+  //Tile (bx, by) reads only row blocks bx and by, so it waits on those
+  //two blocks rather than on every row.
+  for(size_t by = 0; by < numBlocks; by++){
+    for(size_t bx = by; bx < numBlocks; bx++){
+      csize_t y0 = by * step;
+      csize_t y1 = std::min(y0 + step, numRows);
+      csize_t x0 = bx * step;
+      csize_t x1 = std::min(x0 + step, numRows);
+
+      csize_t tile = graph.addTask([&, x0, x1, y0, y1]{
+        if(parallelCancelled()) return;
+        std::vector<f64> rowCrossSums(x1 - x0);
+        for(size_t y = y0; y < y1; y++){
+          f64 *row = tr.getRowSpan(y).first;
+          size_t x = std::max(x0, y);
+          if(x == y){
+            row[0] = 1.0;
+            x++;
+          }
+          if(x >= x1) continue;
+
+          crossSums(rowPointers[y], rowPointers.data() + x, x1 - x,
+                                          numCols, rowCrossSums.data());
+          for(size_t i = x; i < x1; i++){
+            row[i - y] = getCenteredCorrelationBasic(sumsOfSquares[i],
+                                sumsOfSquares[y], rowCrossSums[i - x]);
+          }
+        }
+        reportParallelProgress(1);
+      });
+
+      graph.addDependency(prepared[by], tile);
+      if(bx != by) graph.addDependency(prepared[bx], tile);
+    }
   }
 
-  return NULL;
+  ParallelRegion region("pearson pipeline");
+  beginParallelProgress((numBlocks * (numBlocks+1)) / 2);
+  graph.run();
+
+  if(parallelCancelled()) return UpperDiagonalSquareMatrix<f64>();
+
+  return tr;
 }
 
 
@@ -247,10 +369,15 @@ std::vector<std::vector<double> > calculatePearsonCorrelationMatrix(
   std::vector<double> sumsOfSquares;
   std::vector<std::vector<double> > tr;
   csize_t numRows = expressionData->size();
+  csize_t numCols = numRows > 0 ? (*expressionData)[0].size() : 0;
+  csize_t againstRowsLength = NULL == againstRows ? numRows
+                                                  : againstRows->size();
 
-  sumsOfSquares = centerAndPrecomputeSquares(*expressionData);
+  if(NULL != againstRows && CORRELATION_PATH_CROSS_REFERENCE ==
+                  selectCorrelationPath(CORRELATION_KERNEL_PEARSON, numRows,
+                            numCols, againstRowsLength, autoThreadCount())){
+    sumsOfSquares = centerAndPrecomputeSquares(*expressionData);
 
-  if(NULL != againstRows && againstRows->size() < numRows/2 ){
     tr.reserve(againstRows->size());
     for(size_t i = 0; i < againstRows->size(); i++){
       tr.push_back(std::vector<double>(numRows));
@@ -264,58 +391,204 @@ std::vector<std::vector<double> > calculatePearsonCorrelationMatrix(
       &tr
     };
 
+    ParallelRegion region("pearson cross reference");
+    beginParallelProgress(againstRowsLength);
     autoThreadLauncher(correlationHelperCrossReference, (void*) &instructions);
+    if(parallelCancelled()) tr.clear();
 
 
   }else{
 
-    UpperDiagonalSquareMatrix<double> *corrMatr;
-    corrMatr = new UpperDiagonalSquareMatrix<f64>(numRows);
+    UpperDiagonalSquareMatrix<f64> corrMatr =
+                        calculatePearsonCorrelationTriangle(expressionData);
+    if(parallelCancelled()) return tr;
 
-    CHSBF instructions = {
-      &sumsOfSquares,
-      expressionData,
+    tr.reserve(againstRowsLength);
+    for(size_t i = 0; i < againstRowsLength; i++){
+      tr.push_back(std::vector<double>(numRows));
+    }
 
-      corrMatr
-    };
+    for(size_t yPrime = 0; yPrime < againstRowsLength; yPrime++){
+      corrMatr.getRow(NULL == againstRows ? yPrime
+                          : (*againstRows)[yPrime], tr[yPrime].data());
+    }
 
-    autoThreadLauncher(correlationHelperBruteForce,
-                                                (void*) &instructions);
-    if(NULL == againstRows){
-      tr.reserve(againstRows->size());
-      for(size_t i = 0; i < againstRows->size(); i++){
-        tr.push_back(std::vector<double>(numRows));
-      }
+  }
 
-      for(size_t y = 0; y < numRows; y++){
-        tr[y][y] = 1.0;
-        for(size_t x = y+1; x < numRows; x++){
-          tr[x][y] = tr[y][x] = corrMatr->getValueAtIndex(y, x);
-        }
+  return tr;
+}
+
+
+void *correlationHelperCheckpoint(void *protoArgs){
+
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+
+  CHSCK *args = (CHSCK*)arg->specifics;
+
+  std::vector<double> *sumsOfSquares = args->sumsOfSquares;
+  std::vector<std::vector<double> > *geneCorrData = args->expressionData;
+  csize_t corrVecLeng = (*geneCorrData)[0].size();
+  csize_t numGenes = (*geneCorrData).size();
+  const std::vector<u8> *rowRequested = args->rowRequested;
+  const std::vector<std::vector<size_t> > *resultRowsFor =
+                                                    args->resultRowsFor;
+  CorrelationCheckpoint *checkpoint = args->checkpoint;
+  std::vector<std::vector<double> > *results = args->results;
+
+  csize_t tileSize = checkpoint->getTileSize();
+  csize_t numTiles = checkpoint->numberOfTiles();
+
+  pinnedSumsOfMultipliedArraysFunction crossSums =
+                        selectPinnedSumsOfMultipliedArrays(corrVecLeng);
+  std::vector<cf64*> rowPointers(numGenes);
+  for(size_t x = 0; x < numGenes; x++)
+    rowPointers[x] = (*geneCorrData)[x].data();
+  std::vector<f64> tile(tileSize * tileSize, 0.0);
+
+  for(size_t t = (*args->nextTile)++; t < numTiles && !*args->failed;
+                                              t = (*args->nextTile)++){
+    if(parallelCancelled()) break;
+
+    std::pair<size_t, size_t> tileXY = checkpoint->tileCoordinates(t);
+    csize_t x0 = tileXY.first * tileSize;
+    csize_t y0 = tileXY.second * tileSize;
+    csize_t x1 = std::min(x0 + tileSize, numGenes);
+    csize_t y1 = std::min(y0 + tileSize, numGenes);
+
+    //With a row subset, tiles touching no requested row are skipped.
+    if(NULL != rowRequested){
+      bool needed = false;
+      for(size_t i = y0; i < y1 && !needed; i++) needed = (*rowRequested)[i];
+      for(size_t i = x0; i < x1 && !needed; i++) needed = (*rowRequested)[i];
+      if(!needed){
+        reportParallelProgress(1);
+        continue;
       }
+    }
 
+    if(checkpoint->isTileComplete(t)){
+      if(!checkpoint->readTile(t, tile.data())){
+        *args->failed = true;
+        break;
+      }
     }else{
-      tr.reserve(againstRows->size());
-      for(size_t i = 0; i < againstRows->size(); i++){
-        tr.push_back(std::vector<double>(numRows));
+      for(size_t y = y0; y < y1; y++){
+        csize_t xStart = std::max(x0, y);
+        f64 *tileRow = tile.data() + (y - y0) * tileSize;
+        crossSums(rowPointers[y], rowPointers.data() + xStart,
+              x1 - xStart, corrVecLeng, tileRow + (xStart - x0));
+        for(size_t x = xStart; x < x1; x++){
+          tileRow[x - x0] = x == y ? 1.0 : getCenteredCorrelationBasic(
+                          (*sumsOfSquares)[x], (*sumsOfSquares)[y],
+                                                    tileRow[x - x0]);
+        }
       }
+      if(!checkpoint->writeTile(t, tile.data())){
+        *args->failed = true;
+        break;
+      }
+    }
 
-      for(size_t yPrime = 0; yPrime < againstRows->size(); yPrime++){
-        csize_t y = (*againstRows)[yPrime];
-        for(size_t x = 0; x < numRows; x++){
-          tr[yPrime][x] = corrMatr->getValueAtIndex(y, x);
+    //Every pair belongs to exactly one tile, so no two workers ever
+    //write the same result cell.
+    for(size_t y = y0; y < y1; y++){
+      cf64 *tileRow = tile.data() + (y - y0) * tileSize;
+      for(size_t x = std::max(x0, y); x < x1; x++){
+        cf64 value = tileRow[x - x0];
+        if(NULL == resultRowsFor){
+          (*results)[y][x] = (*results)[x][y] = value;
+        }else{
+          for(size_t p : (*resultRowsFor)[y]) (*results)[p][x] = value;
+          for(size_t p : (*resultRowsFor)[x]) (*results)[p][y] = value;
         }
       }
     }
+    reportParallelProgress(1);
+  }
+
+  return NULL;
+}
+
 
-    delete corrMatr;
+std::vector<std::vector<double> >
+calculatePearsonCorrelationMatrixCheckpointed(
+  std::vector<std::vector<double> > *expressionData,
+  const std::string &checkpointPath,
+  const std::vector<size_t> *againstRows,
+  csize_t tileSize,
+  const bool resume)
+{
+  std::vector<std::vector<double> > tr;
+  csize_t numRows = expressionData->size();
+  if(0 == numRows) return tr;
+  csize_t numCols = (*expressionData)[0].size();
 
+  CorrelationCheckpoint checkpoint;
+  if(!checkpoint.open(checkpointPath, numRows, numCols, tileSize,
+                        hashExpressionData(*expressionData), resume)){
+    return tr;
   }
 
+  //The caller's rows must still hash the same on a retry after a cancel
+  //or failure, or the finished tiles would be discarded, so only a copy
+  //is centered.
+  std::vector<std::vector<double> > centered(*expressionData);
+  std::vector<double> sumsOfSquares = centerAndPrecomputeSquares(centered);
+
+  std::vector<u8> rowRequested;
+  std::vector<std::vector<size_t> > resultRowsFor;
+  if(NULL == againstRows){
+    tr.assign(numRows, std::vector<double>(numRows));
+  }else{
+    tr.assign(againstRows->size(), std::vector<double>(numRows));
+    rowRequested.assign(numRows, 0);
+    resultRowsFor.resize(numRows);
+    for(size_t p = 0; p < againstRows->size(); p++){
+      rowRequested[(*againstRows)[p]] = 1;
+      resultRowsFor[(*againstRows)[p]].push_back(p);
+    }
+  }
+
+  std::atomic<size_t> nextTile(0);
+  std::atomic<bool> failed(false);
+
+  CHSCK instructions = {
+    &sumsOfSquares,
+    &centered,
+    NULL == againstRows ? NULL : &rowRequested,
+    NULL == againstRows ? NULL : &resultRowsFor,
+    &checkpoint,
+    &nextTile,
+    &failed,
+
+    &tr
+  };
+
+  ParallelRegion region("pearson checkpoint");
+  beginParallelProgress(checkpoint.numberOfTiles());
+  autoThreadLauncher(correlationHelperCheckpoint, (void*) &instructions);
+
+  //Tiles finished before a cancel stay in the checkpoint for next time.
+  if(failed || parallelCancelled()) tr.clear();
+
   return tr;
 }
 
 
+extern AsyncResult<std::vector<std::vector<double> > >
+calculatePearsonCorrelationMatrixAsync(
+  std::vector<std::vector<double> > *expressionData,
+  const std::vector<size_t> *againstRows,
+  CancellationToken *token,
+  parallelProgressCallback progress,
+  void *context)
+{
+  return runAsync<std::vector<std::vector<double> > >([=]{
+    return calculatePearsonCorrelationMatrix(expressionData, againstRows);
+  }, token, progress, context);
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
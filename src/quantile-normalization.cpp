@@ -0,0 +1,205 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <utility>
+
+#include <quantile-normalization.hpp>
+#include <short-primatives.h>
+#include <simple-thread-dispatch.hpp>
+#include <timsort.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STRUCTS///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct quantileNormalizationStruct{
+  std::vector<std::vector<double> > *expressionData;
+  //One running sum of sorted columns per worker, indexed by numerator.
+  std::vector<std::vector<f64> > *partialSums;
+  //Mean sorted column, filled in by referenceHelper().
+  std::vector<f64> *reference;
+};
+
+typedef struct quantileNormalizationStruct QNS;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Helper function to quantileNormalize() used with
+ * simple-thread-dispatch().  Sorts a share of the columns and adds them
+ * into that worker's partial sum.
+ **********************************************************************/
+void *sortedColumnSumHelper(void *protoArgs);
+
+
+/*******************************************************************//**
+ * \brief Helper function to quantileNormalize() used with
+ * simple-thread-dispatch().  Reduces a share of the ranks of the
+ * partial sums into the reference distribution.
+ **********************************************************************/
+void *referenceHelper(void *protoArgs);
+
+
+/*******************************************************************//**
+ * \brief Helper function to quantileNormalize() used with
+ * simple-thread-dispatch().  Writes the reference distribution back
+ * into a share of the columns, averaging over ties.
+ **********************************************************************/
+void *scatterReferenceHelper(void *protoArgs);
+
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+void quantileNormalize(std::vector<std::vector<double> > &expressionData){
+  if(expressionData.empty() || expressionData[0].empty()) return;
+
+  csize_t numRows = expressionData.size();
+  //One count for all three launches, so each worker's partial sum slot
+  //exists even if the thread count changes meanwhile.
+  csize_t numThreads = autoThreadCount();
+  std::vector<std::vector<f64> > partialSums(numThreads,
+                                        std::vector<f64>(numRows, 0));
+  std::vector<f64> reference(numRows);
+
+  QNS instructions = {
+      &expressionData,
+      &partialSums,
+      &reference
+    };
+
+  autoThreadLauncher(sortedColumnSumHelper, (void*) &instructions,
+                                                          numThreads);
+  autoThreadLauncher(referenceHelper, (void*) &instructions, numThreads);
+  autoThreadLauncher(scatterReferenceHelper, (void*) &instructions,
+                                                          numThreads);
+}
+
+
+void *sortedColumnSumHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  QNS *args = (QNS*) arg->specifics;
+  const std::vector<std::vector<double> > &expressionData =
+                                                  *args->expressionData;
+  csize_t numRows = expressionData.size();
+  csize_t numCols = expressionData[0].size();
+  std::vector<f64> &partialSum = (*args->partialSums)[numerator];
+
+  csize_t minimum = (numCols * numerator) / denominator;
+  csize_t maximum = (numCols * (numerator+1)) / denominator;
+
+  std::vector<f64> column(numRows);
+  for(size_t x = minimum; x < maximum; x++){
+    for(size_t y = 0; y < numRows; y++) column[y] = expressionData[y][x];
+    madlib::timsortLowToHigh(column.begin(), column.end());
+    for(size_t y = 0; y < numRows; y++) partialSum[y] += column[y];
+  }
+
+  return NULL;
+}
+
+
+void *referenceHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  QNS *args = (QNS*) arg->specifics;
+  const std::vector<std::vector<f64> > &partialSums = *args->partialSums;
+  std::vector<f64> &reference = *args->reference;
+  csize_t numRows = reference.size();
+  csize_t numCols = (*args->expressionData)[0].size();
+
+  csize_t minimum = (numRows * numerator) / denominator;
+  csize_t maximum = (numRows * (numerator+1)) / denominator;
+
+  for(size_t y = minimum; y < maximum; y++){
+    f64 sum = 0;
+    for(size_t t = 0; t < partialSums.size(); t++) sum += partialSums[t][y];
+    reference[y] = sum / numCols;
+  }
+
+  return NULL;
+}
+
+
+void *scatterReferenceHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  QNS *args = (QNS*) arg->specifics;
+  std::vector<std::vector<double> > &expressionData =
+                                                  *args->expressionData;
+  const std::vector<f64> &reference = *args->reference;
+  csize_t numRows = expressionData.size();
+  csize_t numCols = expressionData[0].size();
+
+  csize_t minimum = (numCols * numerator) / denominator;
+  csize_t maximum = (numCols * (numerator+1)) / denominator;
+
+  auto byValue = [](const std::pair<f64, size_t> &left,
+                    const std::pair<f64, size_t> &right){
+      return left.first <= right.first;
+    };
+
+  std::vector<std::pair<f64, size_t> > column(numRows);
+  for(size_t x = minimum; x < maximum; x++){
+    for(size_t y = 0; y < numRows; y++)
+      column[y] = std::pair<f64, size_t>(expressionData[y][x], y);
+    madlib::timsort(column.begin(), column.end(), byValue);
+
+    //Ranks [start, end) hold equal values; give each the mean of the
+    //reference over those ranks.
+    size_t start = 0;
+    while(start < numRows){
+      size_t end = start + 1;
+      f64 sum = reference[start];
+      while(end < numRows && column[end].first == column[start].first)
+        sum += reference[end++];
+
+      cf64 value = sum / (end - start);
+      for(size_t k = start; k < end; k++)
+        expressionData[column[k].second][x] = value;
+      start = end;
+    }
+  }
+
+  return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
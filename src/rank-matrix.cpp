@@ -27,14 +27,18 @@
 #include <stdlib.h>
 #include <utility>
 
+#include <parallel-control.hpp>
+#include <parallel-profile.hpp>
 #include <timsort.hpp>
 #include <rank-matrix.hpp>
 #include <simple-thread-dispatch.hpp>
 
 ////////////////////////////////////////////////////////////////////////
-//PRIVATE STRUCTS///////////////////////////////////////////////////////
+//PRIVATE CONSTANTS/////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+//Rows ranked between progress reports.
+static csize_t RANK_PROGRESS_ROWS = 64;
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -51,37 +55,60 @@ void *rankHelper(void *protoArgs);
 ////////////////////////////////////////////////////////////////////////
 
 void calculateRankMatrix(std::vector<std::vector<double> > &expressionData){
+  ParallelRegion region("rank");
+  beginParallelProgress(expressionData.size());
   autoThreadLauncher(rankHelper, (void*) &expressionData);
 }
 
 
 void *rankHelper(void *protoArgs){
-  void *tmpPtr;
   struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
   csize_t numerator = arg->numerator;
   csize_t denominator = arg->denominator;
 
   std::vector<std::vector<double> > *expressionData = (std::vector<std::vector<double> >*) (arg->specifics);
   csize_t numGenes = (*expressionData).size();
-  csize_t corrVecLeng = (*expressionData)[0].size();
 
   csize_t minimum = (numGenes * numerator) / denominator;
   csize_t maximum = (numGenes * (numerator+1)) / denominator;
 
+  for(size_t first = minimum; first < maximum && !parallelCancelled();
+                                          first += RANK_PROGRESS_ROWS){
+    csize_t last = std::min(first + RANK_PROGRESS_ROWS, maximum);
+    calculateRankRows(*expressionData, first, last);
+    reportParallelProgress(last - first);
+  }
+
+  return NULL;
+}
 
-  for(size_t i = minimum; i < maximum; i++){
-    std::vector<std::pair<f64, size_t> > toSort((*expressionData)[i].size());
+
+void calculateRankRows(std::vector<std::vector<double> > &expressionData,
+                                          size_t first, size_t last){
+  for(size_t i = first; i < last && !parallelCancelled(); i++){
+    csize_t corrVecLeng = expressionData[i].size();
+    std::vector<std::pair<f64, size_t> > toSort(corrVecLeng);
     for(size_t j = 0; j < corrVecLeng; j++){
-      toSort[j] = std::pair<cf64, size_t>((*expressionData)[i][j], j);
+      toSort[j] = std::pair<cf64, size_t>(expressionData[i][j], j);
     }
     std::sort(toSort.begin(), toSort.end());
     for(size_t j = 0; j < corrVecLeng; j++){
-      (*expressionData)[i][toSort[j].second] = j;
+      expressionData[i][toSort[j].second] = j;
     }
   }
+}
 
 
-  return NULL;
+AsyncResult<bool> calculateRankMatrixAsync(
+                          std::vector<std::vector<double> > &expressionData,
+                          CancellationToken *token,
+                          parallelProgressCallback progress,
+                          void *context){
+  std::vector<std::vector<double> > *data = &expressionData;
+  return runAsync<bool>([data]{
+    calculateRankMatrix(*data);
+    return !parallelCancelled();
+  }, token, progress, context);
 }
 
 
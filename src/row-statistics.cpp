@@ -0,0 +1,124 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <online-statistics.hpp>
+#include <row-statistics.hpp>
+#include <simple-thread-dispatch.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STRUCTS///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct rowStatisticsHelperStruct{
+  const std::vector<std::vector<double> > *expressionData;
+  rowStatistics *results;
+};
+
+typedef struct rowStatisticsHelperStruct RSHS;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Helper function to calculateRowStatistics() used with
+ * simple-thread-dispatch().
+ **********************************************************************/
+void *rowStatisticsHelper(void *protoArgs);
+
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+rowStatistics calculateRowStatistics(
+            const std::vector<std::vector<double> > &expressionData){
+  csize_t numRows = expressionData.size();
+  rowStatistics tr;
+
+  tr.count.resize(numRows);
+  tr.nanCount.resize(numRows);
+  tr.mean.resize(numRows);
+  tr.variance.resize(numRows);
+  tr.skewness.resize(numRows);
+  tr.kurtosis.resize(numRows);
+  tr.minimum.resize(numRows);
+  tr.maximum.resize(numRows);
+
+  RSHS instructions = {
+      &expressionData,
+      &tr
+    };
+
+  autoThreadLauncher(rowStatisticsHelper, (void*) &instructions);
+
+  return tr;
+}
+
+
+void *rowStatisticsHelper(void *protoArg){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArg;
+  csize_t denominator = arg->denominator;
+  csize_t numerator = arg->numerator;
+
+  RSHS *args = (RSHS*) arg->specifics;
+  const std::vector<std::vector<double> > &expressionData =
+                                                  *args->expressionData;
+  csize_t numRows = expressionData.size();
+
+  csize_t minimum = (numRows * numerator) / denominator;
+  csize_t maximum = (numRows * (numerator+1)) / denominator;
+
+  for(size_t i = minimum; i < maximum; i++){
+    calculateRowStatistics(expressionData[i].data(),
+                              expressionData[i].size(), *args->results, i);
+  }
+
+  return NULL;
+}
+
+
+void calculateRowStatistics(cf64 *array, csize_t size,
+                                  rowStatistics &results, csize_t row){
+  OnlineMoments moments;
+  moments.push(array, size);
+
+  results.count[row] = moments.getCount();
+  results.nanCount[row] = moments.getNanCount();
+  results.mean[row] = moments.getMean();
+  results.variance[row] = moments.getVariance();
+  results.skewness[row] = moments.getSkewness();
+  results.kurtosis[row] = moments.getKurtosis();
+  results.minimum[row] = moments.getMinimum();
+  results.maximum[row] = moments.getMaximum();
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
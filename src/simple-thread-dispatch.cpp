@@ -23,54 +23,328 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sched.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string>
 #include <thread>
+#include <vector>
 
+#include <parallel-profile.hpp>
 #include <simple-thread-dispatch.hpp>
+#include <thread-pool.hpp>
 
 
 ////////////////////////////////////////////////////////////////////////
-//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+//PRIVATE STRUCTS AND STATE/////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-void autoThreadLauncher(void* (*func)(void*), void *sharedArgs){
-  void *tmpPtr;
+struct threadPolicy{
+  bool fromEnvironment;
+  size_t requestedThreads;
+  bool explicitCPUs;
+  std::vector<size_t> requestedCPUs;
+  bool useSMT;
+
+  //Derived from the above by resolveThreadPolicy().
+  std::vector<size_t> cpus;
+  size_t numThreads;
+};
+
+
+static std::mutex policyLock;
+static threadPolicy policy = {false, 0, false, {}, true, {}, 0};
+//Copy of policy.numThreads, 0 until resolved, for the launch fast path.
+static std::atomic<size_t> resolvedThreads(0);
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static std::vector<size_t> inheritedCPUs(){
+  std::vector<size_t> tr;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  if(0 == sched_getaffinity(0, sizeof(set), &set)){
+    for(size_t cpu = 0; cpu < CPU_SETSIZE; cpu++)
+      if(CPU_ISSET(cpu, &set)) tr.push_back(cpu);
+  }
+
+  if(tr.empty()){
+    csize_t numCPUs = std::thread::hardware_concurrency();
+    for(size_t cpu = 0; cpu < (numCPUs > 0 ? numCPUs : 1); cpu++)
+      tr.push_back(cpu);
+  }
+
+  return tr;
+}
+
+
+//Keep the lowest numbered hardware thread of each core among cpus,
+//which must be ascending.  A CPU is dropped only for a lower numbered
+//sibling which is also in cpus, so a core is never lost to a sibling
+//outside the affinity mask.  CPUs whose topology cannot be read are
+//kept.
+static std::vector<size_t> withoutSMTSiblings(
+                                      const std::vector<size_t> &cpus){
+  std::vector<size_t> tr;
+
+  for(size_t i = 0; i < cpus.size(); i++){
+    std::ifstream file("/sys/devices/system/cpu/cpu"
+            + std::to_string(cpus[i]) + "/topology/thread_siblings_list");
+    std::string line;
+    std::vector<size_t> siblings;
+    bool shadowed = false;
+    if(std::getline(file, line) && parseCPUList(line, siblings)){
+      for(size_t s = 0; s < siblings.size() && siblings[s] < cpus[i]; s++)
+        shadowed |= std::binary_search(cpus.begin(), cpus.end(),
+                                                            siblings[s]);
+    }
+    if(!shadowed) tr.push_back(cpus[i]);
+  }
+
+  return tr;
+}
+
+
+static void readThreadEnvironment(){
+  if(policy.fromEnvironment) return;
+  policy.fromEnvironment = true;
+
+  const char *setting = getenv("MADLIB_NUM_THREADS");
+  if(NULL != setting) policy.requestedThreads = strtoull(setting, NULL, 10);
+
+  setting = getenv("MADLIB_CPU_LIST");
+  std::vector<size_t> cpus;
+  if(NULL != setting && parseCPUList(setting, cpus) && !cpus.empty()){
+    policy.explicitCPUs = true;
+    policy.requestedCPUs = cpus;
+  }
+
+  setting = getenv("MADLIB_SMT");
+  if(NULL != setting) policy.useSMT = 0 != strtoull(setting, NULL, 10);
+}
+
+
+//Call with policyLock held.
+static void resolveThreadPolicy(){
+  readThreadEnvironment();
+
+  policy.cpus = policy.explicitCPUs ? policy.requestedCPUs
+                                    : inheritedCPUs();
+  if(!policy.useSMT) policy.cpus = withoutSMTSiblings(policy.cpus);
+
+  if(0 != policy.requestedThreads){
+    policy.numThreads = policy.requestedThreads;
+  }else{
+    csize_t quota = detectCPUQuota();
+    policy.numThreads = policy.cpus.size();
+    if(0 != quota && quota < policy.numThreads) policy.numThreads = quota;
+  }
+
+  resolvedThreads = policy.numThreads;
+}
+
+
+//As autoThreadLauncher(), timing each share.
+static void profiledThreadLauncher(void* (*func)(void*),
+                  std::vector<struct multithreadLoad> &instructions){
+  csize_t numCPUs = instructions.size();
+  const char *region = currentParallelRegion();
+
+  std::vector<profiledLoad> shares(numCPUs);
+  for(size_t i = 0; i < numCPUs; i++)
+    shares[i] = {&instructions[i], func, region, 0, 0};
+
+  cf64 start = parallelProfileClock();
+  if(numCPUs < 2){
+    profiledShare((void*) &shares[0]);
+  }else{
+    ThreadPool &pool = getThreadPool();
+    threadPoolGroup group;
+    for(size_t i = 1; i < numCPUs; i++)
+      pool.submit(profiledShare, (void*) &shares[i], &group);
+    profiledShare((void*) &shares[0]);
+    pool.wait(&group);
+  }
+  cf64 wall = parallelProfileClock() - start;
+
+  std::vector<f64> busySeconds(numCPUs);
+  std::vector<u64> items(numCPUs);
+  for(size_t i = 0; i < numCPUs; i++){
+    busySeconds[i] = shares[i].busySeconds;
+    items[i] = shares[i].items;
+  }
+  recordParallelRegion(region, wall, busySeconds, items);
+}
+
 
+static bool readFirstLine(const std::string &path, std::string &line){
+  std::ifstream file(path);
+  return (bool) std::getline(file, line);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//FUNCTION DEFINITIONS//////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+size_t autoThreadCount(){
   #ifdef DEBUG
-  csize_t numCPUs = 1;
+  return 1;
   #else
-  csize_t numCPUs = std::thread::hardware_concurrency();
+  size_t tr = resolvedThreads;
+  if(0 != tr) return tr;
+
+  std::lock_guard<std::mutex> guard(policyLock);
+  if(0 == resolvedThreads) resolveThreadPolicy();
+  return resolvedThreads;
   #endif
+}
 
 
-  struct multithreadLoad *instructions;
-  tmpPtr = malloc(sizeof(*instructions) * numCPUs);
-  instructions = (struct multithreadLoad*) tmpPtr;
+void setThreadCount(csize_t numThreads){
+  {
+    std::lock_guard<std::mutex> guard(policyLock);
+    readThreadEnvironment();
+    policy.requestedThreads = numThreads;
+    resolveThreadPolicy();
+  }
+  restartThreadPool();
+}
 
-  for(size_t i = 0; i < numCPUs; i++){
-    instructions[i] = {i, numCPUs, sharedArgs};
+
+bool setThreadCPUList(const std::string &cpuList){
+  std::vector<size_t> cpus;
+  if(!parseCPUList(cpuList, cpus)) return false;
+
+  {
+    std::lock_guard<std::mutex> guard(policyLock);
+    readThreadEnvironment();
+    policy.explicitCPUs = !cpus.empty();
+    policy.requestedCPUs = cpus;
+    resolveThreadPolicy();
   }
+  restartThreadPool();
+  return true;
+}
 
-  if(numCPUs < 2){
-    func((void*) instructions);
+
+void setUseSMTSiblings(const bool useSMT){
+  {
+    std::lock_guard<std::mutex> guard(policyLock);
+    readThreadEnvironment();
+    policy.useSMT = useSMT;
+    resolveThreadPolicy();
+  }
+  restartThreadPool();
+}
+
+
+std::vector<size_t> getThreadCPUs(){
+  std::lock_guard<std::mutex> guard(policyLock);
+  if(0 == resolvedThreads) resolveThreadPolicy();
+  return policy.cpus;
+}
+
+
+bool threadsArePinned(){
+  std::lock_guard<std::mutex> guard(policyLock);
+  readThreadEnvironment();
+  return policy.explicitCPUs;
+}
+
+
+size_t detectCPUQuota(){
+  std::string line;
+  f64 quota = -1, period = -1;
+
+  //cgroup v2: "max 100000" or "<quota> <period>".  In a container the
+  //process's own cgroup is normally mounted as the root.
+  std::string group;
+  std::ifstream self("/proc/self/cgroup");
+  while(std::getline(self, line)){
+    if(0 == line.compare(0, 3, "0::")) group = line.substr(3);
+  }
+  if((!group.empty()
+      && readFirstLine("/sys/fs/cgroup" + group + "/cpu.max", line))
+  || readFirstLine("/sys/fs/cgroup/cpu.max", line)){
+    if(0 == line.compare(0, 3, "max")) return 0;
+    if(2 != sscanf(line.c_str(), "%lf %lf", &quota, &period)) return 0;
   }else{
-    int *toIgnore;
-    pthread_t *workers;
+    //cgroup v1: a quota of -1 is unlimited.
+    std::string periodLine;
+    if(!readFirstLine("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", line)
+    || !readFirstLine("/sys/fs/cgroup/cpu/cpu.cfs_period_us", periodLine))
+      return 0;
+    quota = atof(line.c_str());
+    period = atof(periodLine.c_str());
+  }
+
+  if(quota <= 0 || period <= 0) return 0;
+  csize_t tr = (size_t) ((quota + period - 1) / period);
+  return tr > 0 ? tr : 1;
+}
+
+
+bool parseCPUList(const std::string &cpuList, std::vector<size_t> &cpus){
+  cpus.clear();
+  const char *at = cpuList.c_str();
+
+  while(' ' == *at || '\t' == *at) at++;
+  while('\0' != *at && '\n' != *at){
+    char *end;
+    csize_t first = strtoull(at, &end, 10);
+    if(end == at || first >= CPU_SETSIZE) return false;
+    size_t last = first;
+    at = end;
+
+    if('-' == *at){
+      at++;
+      last = strtoull(at, &end, 10);
+      if(end == at || last < first || last >= CPU_SETSIZE) return false;
+      at = end;
+    }
 
-    tmpPtr = malloc(sizeof(*workers) * numCPUs);
-    workers = (pthread_t*) tmpPtr;
+    for(size_t cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+
+    if(',' == *at) at++;
+    else if('\0' != *at && '\n' != *at) return false;
+  }
+
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return true;
+}
+
+
+void autoThreadLauncher(void* (*func)(void*), void *sharedArgs){
+  autoThreadLauncher(func, sharedArgs, autoThreadCount());
+}
 
-    for(size_t i = 0; i < numCPUs; i++)
-      pthread_create(&workers[i], NULL, func, (void*) &instructions[i]);
 
-    for(size_t i = 0; i < numCPUs; i++)
-      pthread_join(workers[i], (void**) &toIgnore);
+void autoThreadLauncher(void* (*func)(void*), void *sharedArgs,
+                                                csize_t numThreads){
+  csize_t numCPUs = numThreads > 0 ? numThreads : 1;
 
-    free(workers);
+  std::vector<struct multithreadLoad> instructions(numCPUs);
+  for(size_t i = 0; i < numCPUs; i++){
+    instructions[i] = {i, numCPUs, sharedArgs};
   }
 
-  free(instructions);
+  if(parallelProfilingEnabled()){
+    profiledThreadLauncher(func, instructions);
+  }else if(numCPUs < 2){
+    func((void*) instructions.data());
+  }else{
+    getThreadPool().run(func, instructions.data(), numCPUs);
+  }
 }
 
 
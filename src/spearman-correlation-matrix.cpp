@@ -23,11 +23,9 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-#include <stdlib.h>
-#include <string.h>
-
 #include <rank-matrix.hpp>
 #include <correlation-matrix.hpp>
+#include <parallel-control.hpp>
 
 ////////////////////////////////////////////////////////////////////////
 //FUNCTION DEFINITIONS//////////////////////////////////////////////////
@@ -38,18 +36,36 @@ calculateSpearmanCorrelationMatrix(
   std::vector<std::vector<double> > *expressionData,
   const std::vector<size_t> *againstRows)
 {
-  std::vector<std::vector<double> > *rankedMatrix, tr;
-  void *tmpPtr;
+  std::vector<std::vector<double> > rankedMatrix(*expressionData);
+
+  calculateRankMatrix(rankedMatrix);
+  if(parallelCancelled()) return std::vector<std::vector<double> >();
+
+  return calculatePearsonCorrelationMatrix(&rankedMatrix, againstRows);
+}
 
-  *rankedMatrix = *expressionData;
 
-  calculateRankMatrix(*rankedMatrix);
+extern UpperDiagonalSquareMatrix<f64>
+calculateSpearmanCorrelationTriangle(
+  std::vector<std::vector<double> > *expressionData)
+{
+  std::vector<std::vector<double> > rankedMatrix(*expressionData);
 
-  tr = calculatePearsonCorrelationMatrix( rankedMatrix, againstRows);
+  return calculatePipelinedCorrelationTriangle(&rankedMatrix, true);
+}
 
-  delete rankedMatrix;
 
-  return tr;
+extern AsyncResult<std::vector<std::vector<double> > >
+calculateSpearmanCorrelationMatrixAsync(
+  std::vector<std::vector<double> > *expressionData,
+  const std::vector<size_t> *againstRows,
+  CancellationToken *token,
+  parallelProgressCallback progress,
+  void *context)
+{
+  return runAsync<std::vector<std::vector<double> > >([=]{
+    return calculateSpearmanCorrelationMatrix(expressionData, againstRows);
+  }, token, progress, context);
 }
 
 
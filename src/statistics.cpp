@@ -21,14 +21,395 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include <errno.h>
 #include <stdlib.h>
 #include <math.h>
 #include <pthread.h>
+#include <string.h>
+#include <utility>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MADLIB_X86_SIMD
+#endif
+
+#include <fixed-length-statistics.hpp>
 #include <statistics.hpp>
 
 
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STRUCTS///////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct statisticsKernels{
+  f64 (*sum)(cf64 *array, csize_t size);
+  f64 (*sumOfSquares)(cf64 *array, csize_t size);
+  f64 (*sumOfMultipliedArrays)(cf64 *left, cf64 *right, csize_t size);
+};
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Each reduction comes in one variant per instruction set.  The vector
+//variants keep four independent accumulators so consecutive adds do not
+//wait on each other, and are compiled for their instruction set with a
+//target attribute, so the library itself can be built for a baseline
+//CPU and still use the widest units present at run time.
+
+static f64 getSumScalar(cf64 *array, csize_t size){
+  f64 tr = 0;
+  for(size_t i = 0; i < size; i++) tr += array[i];
+  return tr;
+}
+
+
+static f64 getSumOfSquaresScalar(cf64 *array, csize_t size){
+  f64 tr = 0;
+  for(size_t i = 0; i < size; i++) tr += array[i] * array[i];
+  return tr;
+}
+
+
+static f64 getSumOfMultipliedArraysScalar(cf64 *left, cf64 *right,
+                                                          csize_t size){
+  f64 tr = 0;
+  for(size_t i = 0; i < size; i++) tr += (left[i] * right[i]);
+  return tr;
+}
+
+
+#ifdef MADLIB_X86_SIMD
+
+__attribute__((target("sse2")))
+static f64 horizontalSumSSE2(__m128d a, __m128d b, __m128d c, __m128d d){
+  __m128d acc = _mm_add_pd(_mm_add_pd(a, b), _mm_add_pd(c, d));
+  return _mm_cvtsd_f64(acc) + _mm_cvtsd_f64(_mm_unpackhi_pd(acc, acc));
+}
+
+
+__attribute__((target("sse2")))
+static f64 getSumSSE2(cf64 *array, csize_t size){
+  __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 8 <= size; i += 8){
+    a0 = _mm_add_pd(a0, _mm_loadu_pd(array + i));
+    a1 = _mm_add_pd(a1, _mm_loadu_pd(array + i + 2));
+    a2 = _mm_add_pd(a2, _mm_loadu_pd(array + i + 4));
+    a3 = _mm_add_pd(a3, _mm_loadu_pd(array + i + 6));
+  }
+  f64 tr = horizontalSumSSE2(a0, a1, a2, a3);
+  for(; i < size; i++) tr += array[i];
+  return tr;
+}
+
+
+__attribute__((target("sse2")))
+static f64 getSumOfSquaresSSE2(cf64 *array, csize_t size){
+  __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 8 <= size; i += 8){
+    __m128d v0 = _mm_loadu_pd(array + i);
+    __m128d v1 = _mm_loadu_pd(array + i + 2);
+    __m128d v2 = _mm_loadu_pd(array + i + 4);
+    __m128d v3 = _mm_loadu_pd(array + i + 6);
+    a0 = _mm_add_pd(a0, _mm_mul_pd(v0, v0));
+    a1 = _mm_add_pd(a1, _mm_mul_pd(v1, v1));
+    a2 = _mm_add_pd(a2, _mm_mul_pd(v2, v2));
+    a3 = _mm_add_pd(a3, _mm_mul_pd(v3, v3));
+  }
+  f64 tr = horizontalSumSSE2(a0, a1, a2, a3);
+  for(; i < size; i++) tr += array[i] * array[i];
+  return tr;
+}
+
+
+__attribute__((target("sse2")))
+static f64 getSumOfMultipliedArraysSSE2(cf64 *left, cf64 *right,
+                                                          csize_t size){
+  __m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 8 <= size; i += 8){
+    a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_loadu_pd(left + i),
+                                          _mm_loadu_pd(right + i)));
+    a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_loadu_pd(left + i + 2),
+                                          _mm_loadu_pd(right + i + 2)));
+    a2 = _mm_add_pd(a2, _mm_mul_pd(_mm_loadu_pd(left + i + 4),
+                                          _mm_loadu_pd(right + i + 4)));
+    a3 = _mm_add_pd(a3, _mm_mul_pd(_mm_loadu_pd(left + i + 6),
+                                          _mm_loadu_pd(right + i + 6)));
+  }
+  f64 tr = horizontalSumSSE2(a0, a1, a2, a3);
+  for(; i < size; i++) tr += left[i] * right[i];
+  return tr;
+}
+
+
+__attribute__((target("avx2,fma")))
+static f64 horizontalSumAVX2(__m256d a, __m256d b, __m256d c, __m256d d){
+  __m256d acc = _mm256_add_pd(_mm256_add_pd(a, b), _mm256_add_pd(c, d));
+  __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc),
+                                        _mm256_extractf128_pd(acc, 1));
+  return _mm_cvtsd_f64(half) + _mm_cvtsd_f64(_mm_unpackhi_pd(half, half));
+}
+
+
+__attribute__((target("avx2,fma")))
+static f64 getSumAVX2(cf64 *array, csize_t size){
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 16 <= size; i += 16){
+    a0 = _mm256_add_pd(a0, _mm256_loadu_pd(array + i));
+    a1 = _mm256_add_pd(a1, _mm256_loadu_pd(array + i + 4));
+    a2 = _mm256_add_pd(a2, _mm256_loadu_pd(array + i + 8));
+    a3 = _mm256_add_pd(a3, _mm256_loadu_pd(array + i + 12));
+  }
+  for(; i + 4 <= size; i += 4)
+    a0 = _mm256_add_pd(a0, _mm256_loadu_pd(array + i));
+  f64 tr = horizontalSumAVX2(a0, a1, a2, a3);
+  for(; i < size; i++) tr += array[i];
+  return tr;
+}
+
+
+__attribute__((target("avx2,fma")))
+static f64 getSumOfSquaresAVX2(cf64 *array, csize_t size){
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 16 <= size; i += 16){
+    __m256d v0 = _mm256_loadu_pd(array + i);
+    __m256d v1 = _mm256_loadu_pd(array + i + 4);
+    __m256d v2 = _mm256_loadu_pd(array + i + 8);
+    __m256d v3 = _mm256_loadu_pd(array + i + 12);
+    a0 = _mm256_fmadd_pd(v0, v0, a0);
+    a1 = _mm256_fmadd_pd(v1, v1, a1);
+    a2 = _mm256_fmadd_pd(v2, v2, a2);
+    a3 = _mm256_fmadd_pd(v3, v3, a3);
+  }
+  for(; i + 4 <= size; i += 4){
+    __m256d v = _mm256_loadu_pd(array + i);
+    a0 = _mm256_fmadd_pd(v, v, a0);
+  }
+  f64 tr = horizontalSumAVX2(a0, a1, a2, a3);
+  for(; i < size; i++) tr += array[i] * array[i];
+  return tr;
+}
+
+
+__attribute__((target("avx2,fma")))
+static f64 getSumOfMultipliedArraysAVX2(cf64 *left, cf64 *right,
+                                                          csize_t size){
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 16 <= size; i += 16){
+    a0 = _mm256_fmadd_pd(_mm256_loadu_pd(left + i),
+                                    _mm256_loadu_pd(right + i), a0);
+    a1 = _mm256_fmadd_pd(_mm256_loadu_pd(left + i + 4),
+                                    _mm256_loadu_pd(right + i + 4), a1);
+    a2 = _mm256_fmadd_pd(_mm256_loadu_pd(left + i + 8),
+                                    _mm256_loadu_pd(right + i + 8), a2);
+    a3 = _mm256_fmadd_pd(_mm256_loadu_pd(left + i + 12),
+                                    _mm256_loadu_pd(right + i + 12), a3);
+  }
+  for(; i + 4 <= size; i += 4){
+    a0 = _mm256_fmadd_pd(_mm256_loadu_pd(left + i),
+                                    _mm256_loadu_pd(right + i), a0);
+  }
+  f64 tr = horizontalSumAVX2(a0, a1, a2, a3);
+  for(; i < size; i++) tr += left[i] * right[i];
+  return tr;
+}
+
+
+//Spill rather than use _mm512_reduce_add_pd(), whose GCC 12 expansion
+//reads an uninitialized register and warns in every caller.
+__attribute__((target("avx512f")))
+static f64 horizontalSumAVX512(__m512d a, __m512d b, __m512d c, __m512d d){
+  f64 lanes[8];
+  _mm512_storeu_pd(lanes, _mm512_add_pd(_mm512_add_pd(a, b),
+                                        _mm512_add_pd(c, d)));
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+       + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+
+//AVX-512 handles the tail with a masked load instead of a scalar loop.
+__attribute__((target("avx512f")))
+static f64 getSumAVX512(cf64 *array, csize_t size){
+  __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 32 <= size; i += 32){
+    a0 = _mm512_add_pd(a0, _mm512_loadu_pd(array + i));
+    a1 = _mm512_add_pd(a1, _mm512_loadu_pd(array + i + 8));
+    a2 = _mm512_add_pd(a2, _mm512_loadu_pd(array + i + 16));
+    a3 = _mm512_add_pd(a3, _mm512_loadu_pd(array + i + 24));
+  }
+  for(; i + 8 <= size; i += 8)
+    a0 = _mm512_add_pd(a0, _mm512_loadu_pd(array + i));
+  if(i < size){
+    const __mmask8 tail = (__mmask8) ((1u << (size - i)) - 1);
+    a1 = _mm512_add_pd(a1, _mm512_maskz_loadu_pd(tail, array + i));
+  }
+  return horizontalSumAVX512(a0, a1, a2, a3);
+}
+
+
+__attribute__((target("avx512f")))
+static f64 getSumOfSquaresAVX512(cf64 *array, csize_t size){
+  __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 32 <= size; i += 32){
+    __m512d v0 = _mm512_loadu_pd(array + i);
+    __m512d v1 = _mm512_loadu_pd(array + i + 8);
+    __m512d v2 = _mm512_loadu_pd(array + i + 16);
+    __m512d v3 = _mm512_loadu_pd(array + i + 24);
+    a0 = _mm512_fmadd_pd(v0, v0, a0);
+    a1 = _mm512_fmadd_pd(v1, v1, a1);
+    a2 = _mm512_fmadd_pd(v2, v2, a2);
+    a3 = _mm512_fmadd_pd(v3, v3, a3);
+  }
+  for(; i + 8 <= size; i += 8){
+    __m512d v = _mm512_loadu_pd(array + i);
+    a0 = _mm512_fmadd_pd(v, v, a0);
+  }
+  if(i < size){
+    const __mmask8 tail = (__mmask8) ((1u << (size - i)) - 1);
+    __m512d v = _mm512_maskz_loadu_pd(tail, array + i);
+    a1 = _mm512_fmadd_pd(v, v, a1);
+  }
+  return horizontalSumAVX512(a0, a1, a2, a3);
+}
+
+
+__attribute__((target("avx512f")))
+static f64 getSumOfMultipliedArraysAVX512(cf64 *left, cf64 *right,
+                                                          csize_t size){
+  __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for(; i + 32 <= size; i += 32){
+    a0 = _mm512_fmadd_pd(_mm512_loadu_pd(left + i),
+                                    _mm512_loadu_pd(right + i), a0);
+    a1 = _mm512_fmadd_pd(_mm512_loadu_pd(left + i + 8),
+                                    _mm512_loadu_pd(right + i + 8), a1);
+    a2 = _mm512_fmadd_pd(_mm512_loadu_pd(left + i + 16),
+                                    _mm512_loadu_pd(right + i + 16), a2);
+    a3 = _mm512_fmadd_pd(_mm512_loadu_pd(left + i + 24),
+                                    _mm512_loadu_pd(right + i + 24), a3);
+  }
+  for(; i + 8 <= size; i += 8){
+    a0 = _mm512_fmadd_pd(_mm512_loadu_pd(left + i),
+                                    _mm512_loadu_pd(right + i), a0);
+  }
+  if(i < size){
+    const __mmask8 tail = (__mmask8) ((1u << (size - i)) - 1);
+    a1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, left + i),
+                          _mm512_maskz_loadu_pd(tail, right + i), a1);
+  }
+  return horizontalSumAVX512(a0, a1, a2, a3);
+}
+
+#endif
+
+
+//Indexed by simdInstructionSet.  Entries for instruction sets this
+//architecture lacks fall back to the scalar loops.
+static const statisticsKernels KERNELS[] = {
+  {getSumScalar, getSumOfSquaresScalar, getSumOfMultipliedArraysScalar},
+#ifdef MADLIB_X86_SIMD
+  {getSumSSE2, getSumOfSquaresSSE2, getSumOfMultipliedArraysSSE2},
+  {getSumAVX2, getSumOfSquaresAVX2, getSumOfMultipliedArraysAVX2},
+  {getSumAVX512, getSumOfSquaresAVX512, getSumOfMultipliedArraysAVX512},
+#else
+  {getSumScalar, getSumOfSquaresScalar, getSumOfMultipliedArraysScalar},
+  {getSumScalar, getSumOfSquaresScalar, getSumOfMultipliedArraysScalar},
+  {getSumScalar, getSumOfSquaresScalar, getSumOfMultipliedArraysScalar},
+#endif
+};
+
+
+static std::atomic<int> activeInstructionSet(-1);
+
+
+static simdInstructionSet bestSupportedInstructionSet(){
+#ifdef MADLIB_X86_SIMD
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+  if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return SIMD_AVX2;
+  if(__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+  return SIMD_SCALAR;
+}
+
+
+static const statisticsKernels* activeKernels(){
+  int level = activeInstructionSet.load(std::memory_order_relaxed);
+  if(level < 0){
+    simdInstructionSet chosen = bestSupportedInstructionSet();
+
+    const char *requested = getenv("MADLIB_SIMD");
+    if(NULL != requested){
+      simdInstructionSet cap = chosen;
+      if(0 == strcmp(requested, "scalar")) cap = SIMD_SCALAR;
+      else if(0 == strcmp(requested, "sse2")) cap = SIMD_SSE2;
+      else if(0 == strcmp(requested, "avx2")) cap = SIMD_AVX2;
+      else if(0 == strcmp(requested, "avx512")) cap = SIMD_AVX512;
+      if(cap < chosen) chosen = cap;
+    }
+
+    level = chosen;
+    activeInstructionSet.store(level, std::memory_order_relaxed);
+  }
+  return &KERNELS[level];
+}
+
+
+//Pick the kernels when the library is loaded, so the first call does
+//not pay for CPU detection.  Calls made before this runs (from other
+//static initializers) resolve on demand instead.
+static const statisticsKernels *loadTimeKernels = activeKernels();
+
+
+//Adapt the fixed length kernels to the runtime-length signatures so
+//they can share a dispatch table with the generic versions.
+template<size_t N> static f64 sumOfMultipliedArraysFixedAdapter(
+                          cf64 *left, cf64 *right, csize_t size){
+  (void) size;
+  return getSumOfMultipliedArraysFixed<N>(left, right);
+}
+
+
+template<size_t N> static void pinnedSumsOfMultipliedArraysFixedAdapter(
+                        cf64 *pinned, cf64 * const *rows,
+                  csize_t numRows, csize_t size, f64 *results){
+  (void) size;
+  getPinnedSumsOfMultipliedArraysFixed<N>(pinned, rows, numRows,
+                                                              results);
+}
+
+
+template<size_t... I> static const sumOfMultipliedArraysFunction*
+                  sumOfMultipliedArraysTable(std::index_sequence<I...>){
+  static const sumOfMultipliedArraysFunction table[] = {
+    getSumOfMultipliedArrays,
+    sumOfMultipliedArraysFixedAdapter<I+1>...
+  };
+  return table;
+}
+
+
+template<size_t... I> static const pinnedSumsOfMultipliedArraysFunction*
+            pinnedSumsOfMultipliedArraysTable(std::index_sequence<I...>){
+  static const pinnedSumsOfMultipliedArraysFunction table[] = {
+    getPinnedSumsOfMultipliedArrays,
+    pinnedSumsOfMultipliedArraysFixedAdapter<I+1>...
+  };
+  return table;
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 //PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -66,9 +447,7 @@ f64 getMean(cf64 *array, csize_t size){
 
 
 f64 getSum(cf64 *array, csize_t size){
-  f64 tr = 0;
-  for(size_t i = 0; i < size; i++) tr += array[i];
-  return tr;
+  return activeKernels()->sum(array, size);
 }
 
 
@@ -80,17 +459,55 @@ size_t getIntegerSum(csize_t *array, csize_t size){
 
 
 f64 getSumOfSquares(cf64 *array, csize_t size){
-  return getSumOfMultipliedArrays(array, array, size);
+  return activeKernels()->sumOfSquares(array, size);
 }
 
 
 f64 getSumOfMultipliedArrays(cf64 *left, cf64 *right, csize_t size){
-  f64 tr = 0;
+  return activeKernels()->sumOfMultipliedArrays(left, right, size);
+}
 
-  for(size_t i = 0; i < size; i++)
-    tr += (left[i] * right[i]);
 
-  return tr;
+simdInstructionSet getStatisticsInstructionSet(){
+  activeKernels();
+  return (simdInstructionSet) activeInstructionSet.load(
+                                              std::memory_order_relaxed);
+}
+
+
+bool setStatisticsInstructionSet(const simdInstructionSet level){
+  if(level < SIMD_SCALAR || level > bestSupportedInstructionSet())
+    return false;
+  activeInstructionSet.store(level, std::memory_order_relaxed);
+  return true;
+}
+
+
+void getPinnedSumsOfMultipliedArrays(cf64 *pinned, cf64 * const *rows,
+                      csize_t numRows, csize_t size, f64 *results){
+  for(size_t r = 0; r < numRows; r++)
+    results[r] = getSumOfMultipliedArrays(pinned, rows[r], size);
+}
+
+
+sumOfMultipliedArraysFunction selectSumOfMultipliedArrays(csize_t size){
+  static const sumOfMultipliedArraysFunction *table =
+    sumOfMultipliedArraysTable(
+                std::make_index_sequence<MAX_FIXED_KERNEL_LENGTH>());
+
+  if(0 == size || size > MAX_FIXED_KERNEL_LENGTH) return table[0];
+  return table[size];
+}
+
+
+pinnedSumsOfMultipliedArraysFunction
+                      selectPinnedSumsOfMultipliedArrays(csize_t size){
+  static const pinnedSumsOfMultipliedArraysFunction *table =
+    pinnedSumsOfMultipliedArraysTable(
+                std::make_index_sequence<MAX_FIXED_KERNEL_LENGTH>());
+
+  if(0 == size || size > MAX_FIXED_KERNEL_LENGTH) return table[0];
+  return table[size];
 }
 
 
@@ -148,6 +565,99 @@ f64 covarianceTwo(cf64 *left, cf64 *right, csize_t arrayLength){
   return getSumOfMultipliedArrays(l, r, s) / (2.0 * s * s);
 }
 
+
+//Modified Lentz evaluation of the continued fraction for I_x(a, b),
+//which converges quickly for x < (a+1)/(a+b+2).
+static f64 incompleteBetaContinuedFraction(cf64 a, cf64 b, cf64 x){
+  cf64 tiny = 1e-300;
+  cf64 epsilon = 1e-15;
+  cf64 qab = a + b, qap = a + 1, qam = a - 1;
+
+  f64 c = 1, d = 1 - qab * x / qap;
+  if(fabs(d) < tiny) d = tiny;
+  d = 1 / d;
+  f64 tr = d;
+
+  for(size_t m = 1; m <= 1000; m++){
+    csize_t m2 = 2 * m;
+    f64 aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+    d = 1 + aa * d;
+    if(fabs(d) < tiny) d = tiny;
+    c = 1 + aa / c;
+    if(fabs(c) < tiny) c = tiny;
+    d = 1 / d;
+    tr *= d * c;
+
+    aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+    d = 1 + aa * d;
+    if(fabs(d) < tiny) d = tiny;
+    c = 1 + aa / c;
+    if(fabs(c) < tiny) c = tiny;
+    d = 1 / d;
+    cf64 delta = d * c;
+    tr *= delta;
+    if(fabs(delta - 1) < epsilon) break;
+  }
+
+  return tr;
+}
+
+
+f64 regularizedIncompleteBeta(cf64 a, cf64 b, cf64 x){
+  return regularizedIncompleteBeta(a, b, x, 1 - x);
+}
+
+
+f64 regularizedIncompleteBeta(cf64 a, cf64 b, cf64 x, cf64 oneMinusX){
+  if(x <= 0) return 0;
+  if(oneMinusX <= 0) return 1;
+
+  cf64 front = exp(lgamma(a + b) - lgamma(a) - lgamma(b)
+                                      + a * log(x) + b * log(oneMinusX));
+
+  //Use the symmetry I_x(a, b) = 1 - I_(1-x)(b, a) to stay on the side
+  //where the continued fraction converges.
+  if(x < (a + 1) / (a + b + 2))
+    return front * incompleteBetaContinuedFraction(a, b, x) / a;
+  return 1 - front * incompleteBetaContinuedFraction(b, a, oneMinusX) / b;
+}
+
+
+f64 logRegularizedIncompleteBeta(cf64 a, cf64 b, cf64 x){
+  return logRegularizedIncompleteBeta(a, b, x, 1 - x);
+}
+
+
+f64 logRegularizedIncompleteBeta(cf64 a, cf64 b, cf64 x,
+                                                      cf64 oneMinusX){
+  if(x <= 0) return -INFINITY;
+  if(oneMinusX <= 0) return 0;
+
+  cf64 logFront = lgamma(a + b) - lgamma(a) - lgamma(b)
+                                      + a * log(x) + b * log(oneMinusX);
+
+  if(x < (a + 1) / (a + b + 2))
+    return logFront + log(incompleteBetaContinuedFraction(a, b, x) / a);
+  return log1p(-exp(logFront)
+                * incompleteBetaContinuedFraction(b, a, oneMinusX) / b);
+}
+
+
+f64 getStudentTPValue(cf64 t, cf64 degreesOfFreedom){
+  if(isnan(t) || isnan(degreesOfFreedom)) return NAN;
+  return regularizedIncompleteBeta(degreesOfFreedom / 2, 0.5,
+                            degreesOfFreedom / (degreesOfFreedom + t * t));
+}
+
+
+f64 getFPValue(cf64 f, cf64 numeratorDegreesOfFreedom,
+                                    cf64 denominatorDegreesOfFreedom){
+  cf64 d1 = numeratorDegreesOfFreedom, d2 = denominatorDegreesOfFreedom;
+  if(isnan(f) || isnan(d1) || isnan(d2)) return NAN;
+  if(f <= 0) return 1;
+  return regularizedIncompleteBeta(d2 / 2, d1 / 2, d2 / (d2 + d1 * f));
+}
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -0,0 +1,168 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <parallel-profile.hpp>
+#include <task-graph.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TaskGraph::TaskGraph(){
+  pool = NULL;
+  group = NULL;
+  profiling = false;
+  region = NULL;
+}
+
+
+size_t TaskGraph::addTask(std::function<void()> work){
+  nodes.emplace_back();
+  taskNode &node = nodes.back();
+  node.work = work;
+  node.numPredecessors = 0;
+  node.waitingOn = 0;
+  node.graph = this;
+  node.busySeconds = 0;
+  node.threadSlot = 0;
+  return nodes.size() - 1;
+}
+
+
+void TaskGraph::addDependency(csize_t before, csize_t after){
+  nodes[before].successors.push_back(after);
+  nodes[after].numPredecessors++;
+}
+
+
+size_t TaskGraph::numberOfTasks() const{
+  return nodes.size();
+}
+
+
+//Kahn's algorithm: every task is reached only if nothing waits on a
+//cycle.
+bool TaskGraph::isAcyclic() const{
+  std::vector<size_t> waitingOn(nodes.size());
+  std::vector<size_t> ready;
+  for(size_t i = 0; i < nodes.size(); i++){
+    waitingOn[i] = nodes[i].numPredecessors;
+    if(0 == waitingOn[i]) ready.push_back(i);
+  }
+
+  size_t reached = 0;
+  while(!ready.empty()){
+    csize_t task = ready.back();
+    ready.pop_back();
+    reached++;
+    const std::vector<size_t> &successors = nodes[task].successors;
+    for(size_t i = 0; i < successors.size(); i++)
+      if(0 == --waitingOn[successors[i]]) ready.push_back(successors[i]);
+  }
+
+  return reached == nodes.size();
+}
+
+
+//Shares are the threads which ran tasks, in order of first appearance.
+void TaskGraph::recordRun(cf64 wallSeconds){
+  std::vector<size_t> shareOfSlot;
+  std::vector<f64> busySeconds;
+  std::vector<u64> items;
+
+  for(size_t i = 0; i < nodes.size(); i++){
+    csize_t slot = nodes[i].threadSlot;
+    if(slot >= shareOfSlot.size()) shareOfSlot.resize(slot+1, (size_t) -1);
+    if((size_t) -1 == shareOfSlot[slot]){
+      shareOfSlot[slot] = busySeconds.size();
+      busySeconds.push_back(0);
+      items.push_back(0);
+    }
+    busySeconds[shareOfSlot[slot]] += nodes[i].busySeconds;
+    items[shareOfSlot[slot]]++;
+  }
+
+  recordParallelRegion(region, wallSeconds, busySeconds, items);
+}
+
+
+void *TaskGraph::runTaskNode(void *protoArgs){
+  taskNode *node = (taskNode*) protoArgs;
+  TaskGraph *graph = node->graph;
+
+  if(graph->profiling){
+    ParallelRegion named(graph->region);
+    cf64 start = parallelProfileClock();
+    node->work();
+    node->busySeconds = parallelProfileClock() - start;
+    node->threadSlot = parallelProfileThreadSlot();
+  }else{
+    node->work();
+  }
+
+  //Successors are queued before this task is counted finished, so the
+  //group cannot drain while work remains.
+  for(size_t i = 0; i < node->successors.size(); i++){
+    taskNode &next = graph->nodes[node->successors[i]];
+    if(1 == next.waitingOn.fetch_sub(1))
+      graph->pool->submit(runTaskNode, (void*) &next, graph->group);
+  }
+
+  return NULL;
+}
+
+
+bool TaskGraph::run(){
+  if(!isAcyclic()) return false;
+
+  threadPoolGroup runGroup;
+  pool = &getThreadPool();
+  group = &runGroup;
+  profiling = parallelProfilingEnabled();
+  region = currentParallelRegion();
+  cf64 start = profiling ? parallelProfileClock() : 0;
+
+  for(size_t i = 0; i < nodes.size(); i++)
+    nodes[i].waitingOn = nodes[i].numPredecessors;
+
+  for(size_t i = 0; i < nodes.size(); i++)
+    if(0 == nodes[i].numPredecessors)
+      pool->submit(runTaskNode, (void*) &nodes[i], group);
+
+  pool->wait(group);
+
+  if(profiling) recordRun(parallelProfileClock() - start);
+
+  pool = NULL;
+  group = NULL;
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
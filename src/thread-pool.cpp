@@ -0,0 +1,181 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <thread-pool.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE STATE/////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static std::mutex processPoolLock;
+static std::unique_ptr<ThreadPool> processPool;
+
+
+////////////////////////////////////////////////////////////////////////
+//CLASS FUNCTION DEFINITIONS////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool(csize_t numWorkers,
+                                    const std::vector<size_t> &pinTo){
+  stopping = false;
+  workers.reserve(numWorkers);
+  for(size_t i = 0; i < numWorkers; i++){
+    workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    csize_t cpu = pinTo.empty() ? CPU_SETSIZE : pinTo[(i+1) % pinTo.size()];
+    if(cpu >= CPU_SETSIZE) continue;
+
+    //Pinning is best effort; an unavailable CPU leaves the worker free.
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(workers[i].native_handle(), sizeof(set), &set);
+  }
+}
+
+
+ThreadPool::~ThreadPool(){
+  {
+    std::lock_guard<std::mutex> guard(queueLock);
+    stopping = true;
+  }
+  changed.notify_all();
+  for(size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+
+size_t ThreadPool::numberOfWorkers() const{
+  return workers.size();
+}
+
+
+void ThreadPool::runTask(threadPoolTask task){
+  ParallelControl *previous = swapParallelControl(task.control);
+  task.func(task.arg);
+  swapParallelControl(previous);
+
+  //The waiter checks pending under the lock before sleeping, so taking
+  //the lock here before notifying cannot miss it.
+  if(1 == task.group->pending.fetch_sub(1)){
+    std::lock_guard<std::mutex> guard(queueLock);
+    changed.notify_all();
+  }
+}
+
+
+void ThreadPool::workerLoop(){
+  std::unique_lock<std::mutex> lock(queueLock);
+  while(true){
+    if(!queue.empty()){
+      threadPoolTask task = queue.front();
+      queue.pop_front();
+      lock.unlock();
+      runTask(task);
+      lock.lock();
+    }else if(stopping){
+      return;
+    }else{
+      changed.wait(lock);
+    }
+  }
+}
+
+
+void ThreadPool::submit(void* (*func)(void*), void *arg,
+                                                threadPoolGroup *group){
+  group->pending++;
+  {
+    std::lock_guard<std::mutex> guard(queueLock);
+    queue.push_back({func, arg, group, currentParallelControl()});
+  }
+  //A waiter only takes jobs of its own group, so waking just one thread
+  //could wake a waiter which leaves this job for a worker still asleep.
+  changed.notify_all();
+}
+
+
+void ThreadPool::wait(threadPoolGroup *group){
+  std::unique_lock<std::mutex> lock(queueLock);
+  while(group->pending > 0){
+    //Only jobs of this group are taken, so a short wait is never held up
+    //behind someone else's long job, such as a whole runAsync() call.
+    std::deque<threadPoolTask>::iterator own = queue.begin();
+    while(queue.end() != own && group != own->group) own++;
+
+    if(queue.end() != own){
+      threadPoolTask task = *own;
+      queue.erase(own);
+      lock.unlock();
+      runTask(task);
+      lock.lock();
+    }else{
+      changed.wait(lock);
+    }
+  }
+}
+
+
+void ThreadPool::run(void* (*func)(void*), struct multithreadLoad *loads,
+                                                        csize_t count){
+  if(0 == count) return;
+
+  threadPoolGroup group;
+  for(size_t i = 1; i < count; i++)
+    submit(func, (void*) &loads[i], &group);
+
+  func((void*) &loads[0]);
+  wait(&group);
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+ThreadPool& getThreadPool(){
+  std::lock_guard<std::mutex> guard(processPoolLock);
+  if(!processPool){
+    csize_t numWorkers = autoThreadCount() - 1;
+    processPool.reset(threadsArePinned()
+                      ? new ThreadPool(numWorkers, getThreadCPUs())
+                      : new ThreadPool(numWorkers));
+  }
+  return *processPool;
+}
+
+
+void restartThreadPool(){
+  std::lock_guard<std::mutex> guard(processPoolLock);
+  processPool.reset();
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
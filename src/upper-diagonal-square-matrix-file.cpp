@@ -0,0 +1,361 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <simple-thread-dispatch.hpp>
+#include <upper-diagonal-square-matrix-file.hpp>
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE CONSTANTS AND STRUCTS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static const char MATRIX_FILE_MAGIC[8] = {'M','A','D','L','U','D','S','M'};
+static cu32 MATRIX_FILE_VERSION = 1;
+//Written as is; reads back differently on a machine of the other
+//byte order.
+static cu32 MATRIX_FILE_BYTE_ORDER = 0x01020304;
+static csize_t MATRIX_FILE_DATA_OFFSET = 4096;
+static csize_t CHECKSUM_BLOCK_SIZE = 1 << 20;
+
+static cu64 PRIME_1 = 0x9E3779B185EBCA87ULL;
+static cu64 PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static cu64 PRIME_3 = 0x165667B19E3779F9ULL;
+
+
+struct matrixFileHeader{
+  char magic[8];
+  u32 version;
+  u32 byteOrder;
+  u32 elementType;
+  u32 elementSize;
+  u64 sideLength;
+  u32 layout;
+  u32 tileSize;
+  u64 numElements;
+  u64 dataOffset;
+  u64 checksum;
+};
+
+
+struct checksumStruct{
+  cu8 *data;
+  size_t size;
+  std::vector<u64> *blockHashes;
+};
+
+typedef struct checksumStruct CS;
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DECLARATIONS/////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+/*******************************************************************//**
+ * \brief Helper function to checksumMatrixData() used with
+ * simple-thread-dispatch().  Hashes a share of the blocks.
+ **********************************************************************/
+void *checksumHelper(void *protoArgs);
+
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static inline u64 rotateLeft(cu64 value, const int bits){
+  return (value << bits) | (value >> (64 - bits));
+}
+
+
+static u64 hashBlock(cu8 *data, csize_t size){
+  u64 lanes[4] = {PRIME_1, PRIME_2, PRIME_3, PRIME_1 ^ PRIME_2};
+  size_t i = 0;
+
+  for(; i + 32 <= size; i += 32){
+    for(size_t j = 0; j < 4; j++){
+      u64 word;
+      memcpy(&word, data + i + 8*j, sizeof(word));
+      lanes[j] = rotateLeft(lanes[j] + word * PRIME_2, 31) * PRIME_1;
+    }
+  }
+
+  u64 tr = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7)
+              + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+  for(; i < size; i++) tr = rotateLeft(tr ^ (data[i] * PRIME_3), 11) * PRIME_1;
+
+  tr ^= size;
+  tr ^= tr >> 33;
+  tr *= PRIME_2;
+  tr ^= tr >> 29;
+  return tr;
+}
+
+
+//pread()/pwrite() may transfer less than asked; loop until done.
+static bool preadFully(int fd, void *buffer, size_t size, off_t offset){
+  u8 *at = (u8*) buffer;
+  while(size > 0){
+    ssize_t got = pread(fd, at, size, offset);
+    if(got < 0 && EINTR == errno) continue;
+    if(got <= 0) return false;
+    at += got;
+    size -= got;
+    offset += got;
+  }
+  return true;
+}
+
+
+static bool pwriteFully(int fd, const void *buffer, size_t size,
+                                                          off_t offset){
+  const u8 *at = (const u8*) buffer;
+  while(size > 0){
+    ssize_t put = pwrite(fd, at, size, offset);
+    if(put < 0 && EINTR == errno) continue;
+    if(put <= 0) return false;
+    at += put;
+    size -= put;
+    offset += put;
+  }
+  return true;
+}
+
+
+static bool readHeader(int fd, matrixFileHeader &header){
+  if(!preadFully(fd, &header, sizeof(header), 0)) return false;
+
+  return 0 == memcmp(header.magic, MATRIX_FILE_MAGIC, sizeof(header.magic))
+      && MATRIX_FILE_VERSION == header.version
+      && MATRIX_FILE_BYTE_ORDER == header.byteOrder
+      && MATRIX_FILE_DATA_OFFSET == header.dataOffset;
+}
+
+
+static bool matchesDescription(const matrixFileHeader &header,
+                                const matrixFileDescription &expected){
+  return header.elementType == expected.elementType
+      && header.elementSize == expected.elementSize
+      && header.sideLength == expected.sideLength
+      && header.layout == expected.layout
+      && header.tileSize == expected.tileSize
+      && header.numElements == expected.numElements;
+}
+
+
+//Whether the file is long enough for the data its header claims, without
+//overflowing on a damaged element count.
+static bool holdsData(int fd, const matrixFileHeader &header){
+  struct stat status;
+  if(0 != fstat(fd, &status) || 0 == header.elementSize
+  || (u64) status.st_size < MATRIX_FILE_DATA_OFFSET)
+    return false;
+  cu64 room = ((u64) status.st_size - MATRIX_FILE_DATA_OFFSET)
+                                                  / header.elementSize;
+  return header.numElements <= room;
+}
+
+
+//Open, check the header against expected, and check the file is long
+//enough for the data it claims.
+static int openMatching(const std::string &path,
+        const matrixFileDescription &expected, matrixFileHeader &header){
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0) return -1;
+
+  if(!readHeader(fd, header) || !matchesDescription(header, expected)
+  || !holdsData(fd, header)){
+    ::close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//PUBLIC FUNCTION DEFINITIONS///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+u64 checksumMatrixData(const void *data, csize_t size){
+  std::vector<u64> blockHashes(
+                    (size + CHECKSUM_BLOCK_SIZE-1) / CHECKSUM_BLOCK_SIZE);
+  CS instructions = {(cu8*) data, size, &blockHashes};
+
+  autoThreadLauncher(checksumHelper, (void*) &instructions);
+
+  u64 tr = PRIME_3 ^ size;
+  for(size_t i = 0; i < blockHashes.size(); i++)
+    tr = rotateLeft(tr ^ blockHashes[i], 27) * PRIME_1 + PRIME_2;
+  return tr;
+}
+
+
+void *checksumHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  csize_t numerator = arg->numerator;
+  csize_t denominator = arg->denominator;
+
+  CS *args = (CS*) arg->specifics;
+  std::vector<u64> &blockHashes = *args->blockHashes;
+  csize_t minimum = (blockHashes.size() * numerator) / denominator;
+  csize_t maximum = (blockHashes.size() * (numerator+1)) / denominator;
+
+  for(size_t b = minimum; b < maximum; b++){
+    csize_t start = b * CHECKSUM_BLOCK_SIZE;
+    csize_t size = std::min(CHECKSUM_BLOCK_SIZE, args->size - start);
+    blockHashes[b] = hashBlock(args->data + start, size);
+  }
+
+  return NULL;
+}
+
+
+bool writeMatrixFile(const std::string &path,
+          const matrixFileDescription &description, const void *data){
+  u8 header[MATRIX_FILE_DATA_OFFSET];
+  matrixFileHeader fields;
+  csize_t dataSize = description.numElements * description.elementSize;
+
+  memset(&fields, 0, sizeof(fields));
+  memcpy(fields.magic, MATRIX_FILE_MAGIC, sizeof(fields.magic));
+  fields.version = MATRIX_FILE_VERSION;
+  fields.byteOrder = MATRIX_FILE_BYTE_ORDER;
+  fields.elementType = description.elementType;
+  fields.elementSize = description.elementSize;
+  fields.sideLength = description.sideLength;
+  fields.layout = description.layout;
+  fields.tileSize = description.tileSize;
+  fields.numElements = description.numElements;
+  fields.dataOffset = MATRIX_FILE_DATA_OFFSET;
+  fields.checksum = checksumMatrixData(data, dataSize);
+  memset(header, 0, sizeof(header));
+  memcpy(header, &fields, sizeof(fields));
+
+  const std::string temporary = path + ".tmp";
+  int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if(fd < 0) return false;
+
+  bool ok = pwriteFully(fd, header, sizeof(header), 0)
+          && pwriteFully(fd, data, dataSize, MATRIX_FILE_DATA_OFFSET)
+          && 0 == fdatasync(fd);
+  ok = 0 == ::close(fd) && ok;
+  ok = ok && 0 == rename(temporary.c_str(), path.c_str());
+  if(!ok) unlink(temporary.c_str());
+
+  return ok;
+}
+
+
+bool readMatrixFileDescription(const std::string &path,
+                                    matrixFileDescription &description){
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0) return false;
+
+  matrixFileHeader header;
+  const bool tr = readHeader(fd, header) && holdsData(fd, header);
+  ::close(fd);
+  if(!tr) return false;
+
+  description.elementType = header.elementType;
+  description.elementSize = header.elementSize;
+  description.sideLength = header.sideLength;
+  description.layout = header.layout;
+  description.tileSize = header.tileSize;
+  description.numElements = header.numElements;
+  return true;
+}
+
+
+bool matrixDescriptionsMatch(const matrixFileDescription &found,
+                              const matrixFileDescription &expected){
+  return found.elementType == expected.elementType
+      && found.elementSize == expected.elementSize
+      && found.sideLength == expected.sideLength
+      && found.layout == expected.layout
+      && found.tileSize == expected.tileSize
+      && found.numElements == expected.numElements;
+}
+
+
+bool readMatrixFile(const std::string &path,
+                const matrixFileDescription &expected, void *data){
+  matrixFileHeader header;
+  int fd = openMatching(path, expected, header);
+  if(fd < 0) return false;
+
+  csize_t dataSize = header.numElements * header.elementSize;
+  const bool tr = preadFully(fd, data, dataSize, MATRIX_FILE_DATA_OFFSET)
+                  && header.checksum == checksumMatrixData(data, dataSize);
+  ::close(fd);
+  return tr;
+}
+
+
+void *mapMatrixFile(const std::string &path,
+                const matrixFileDescription &expected, const bool verify,
+                                                  size_t &mappingSize){
+  matrixFileHeader header;
+  int fd = openMatching(path, expected, header);
+  if(fd < 0) return NULL;
+
+  csize_t dataSize = header.numElements * header.elementSize;
+  mappingSize = MATRIX_FILE_DATA_OFFSET + dataSize;
+  void *tr = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(MAP_FAILED == tr) return NULL;
+
+  if(verify && header.checksum != checksumMatrixData(
+                      (cu8*) tr + MATRIX_FILE_DATA_OFFSET, dataSize)){
+    munmap(tr, mappingSize);
+    return NULL;
+  }
+
+  return tr;
+}
+
+
+void unmapMatrixFile(void *mapping, csize_t mappingSize){
+  if(NULL != mapping) munmap(mapping, mappingSize);
+}
+
+
+size_t matrixFileDataOffset(){
+  return MATRIX_FILE_DATA_OFFSET;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
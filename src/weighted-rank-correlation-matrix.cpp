@@ -24,7 +24,10 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include <correlation-matrix.hpp>
+#include <correlation-path-selector.hpp>
 #include <timsort.hpp>
 #include <simple-thread-dispatch.hpp>
 #include <statistics.hpp>
@@ -210,38 +213,31 @@ void *correlationHelperBruteForce(void *protoArgs){
   csize_t maximum = (results->numberOfElements() * (numerator+1))
                                                           / denominator;
 
-  //TODO: optimize index calculation by moving x and y into their own
-  //loops and just use the WToXY to establish start and end.  Also
-  //include primer loops
+  //This worker's share starts part way along one row and ends part way
+  //along another; locate the start once, then fill whole row spans.
+  if(minimum >= maximum) return NULL;
   std::pair<size_t, size_t> startXY = results->WtoXY(minimum);
-  std::pair<size_t, size_t> endXY = results->WtoXY(maximum);
-  csize_t tmpSY = startXY.second;
-
-  for(size_t x = startXY.first; x < numGenes; x++){
-    cf64 abCrossSum = getSumOfMultipliedArrays(geneCorrData[x],
-                                      geneCorrData[tmpSY], corrVecLeng);
-    results->setValueAtIndex(x, tmpSY, getCenteredCorrelationBasic(
-                  sumsOfSquares[x], sumsOfSquares[tmpSY], abCrossSum));
-  }
+  size_t remaining = maximum - minimum;
+
+  for(size_t y = startXY.second, x = startXY.first; remaining > 0;
+                                                            y++, x = y){
+    f64 *row = results->getRowSpan(y).first;
+    csize_t end = std::min(numGenes, x + remaining);
+    remaining -= end - x;
+
+    if(x == y){
+      row[0] = 1.0;
+      x++;
+    }
 
-  for(size_t y = startXY.second+1; y < endXY.second; y++){
-    results->setValueAtIndex(y, y, 1.0);
-    for(size_t x = y+1; x < numGenes; x++){
+    for(; x < end; x++){
       cf64 abCrossSum = getSumOfMultipliedArrays(geneCorrData[x],
                                       geneCorrData[y], corrVecLeng);
-      results->setValueAtIndex(x, y, getCenteredCorrelationBasic(
-                    sumsOfSquares[x], sumsOfSquares[y], abCrossSum));
+      row[x - y] = getCenteredCorrelationBasic(sumsOfSquares[x],
+                                          sumsOfSquares[y], abCrossSum);
     }
   }
 
-  csize_t tmpEY = endXY.second;
-    for(size_t x = tmpEY; x < endXY.first; x++){
-    cf64 abCrossSum = getSumOfMultipliedArrays(geneCorrData[x],
-                                      geneCorrData[tmpEY], corrVecLeng);
-    results->setValueAtIndex(x, tmpEY, getCenteredCorrelationBasic(
-                  sumsOfSquares[x], sumsOfSquares[tmpEY], abCrossSum));
-  }
-
   return NULL;
 }
 
@@ -259,7 +255,9 @@ f64** calculateWeightedRankCorrelationMatrix(cf64 **expressionData,
   sumsOfSquares = centerAndPrecomputeSquares(expressionData, numRows,
                                                               numCols);
 
-  if(NULL != againstRows && againstRowsLength < numRows/2 ){
+  if(NULL != againstRows && CORRELATION_PATH_CROSS_REFERENCE ==
+                  selectCorrelationPath(CORRELATION_KERNEL_PEARSON, numRows,
+                            numCols, againstRowsLength, autoThreadCount())){
 
     tmpPtr = malloc(sizeof(*tr) * againstRowsLength);
     tr = (f64**) tmpPtr; //[TF index][gene index]
@@ -286,6 +284,8 @@ f64** calculateWeightedRankCorrelationMatrix(cf64 **expressionData,
 
     UpperDiagonalSquareMatrix<f64> *corrMatr;
     corrMatr = new UpperDiagonalSquareMatrix<f64>(numRows);
+    //Touch the triangle with the same split the helper uses.
+    corrMatr->zeroData();
 
     CHSBF instructions = {
       sumsOfSquares,
@@ -324,10 +324,7 @@ f64** calculateWeightedRankCorrelationMatrix(cf64 **expressionData,
       }
 
       for(size_t yPrime = 0; yPrime < againstRowsLength; yPrime++){
-        csize_t y = againstRows[yPrime];
-        for(size_t x = 0; x < numRows; x++){
-          tr[yPrime][x] = corrMatr->getValueAtIndex(y, x);
-        }
+        corrMatr->getRow(againstRows[yPrime], tr[yPrime]);
       }
     }
 
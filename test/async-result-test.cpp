@@ -0,0 +1,148 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <vector>
+
+#include <async-result.hpp>
+#include <correlation-matrix.hpp>
+#include <rank-matrix.hpp>
+#include <simple-thread-dispatch.hpp>
+
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static void countReports(const char*, csize_t, csize_t, void *context){
+  (*(std::atomic<size_t>*) context)++;
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(ASYNC_RESULT, MATCHES_BLOCKING_CALLS){
+  //One thread runs jobs inside runAsync(); more queue them.
+  for(size_t threads : {1, 4}){
+    setThreadCount(threads);
+
+    std::vector<std::vector<double> > data = correlationTestData(80, 10, 0);
+    std::vector<std::vector<double> > copy = data;
+    std::vector<size_t> againstRows = {5, 0, 79};
+
+    std::vector<std::vector<double> > blocking =
+                    calculateSpearmanCorrelationMatrix(&copy, &againstRows);
+    AsyncResult<std::vector<std::vector<double> > > pending =
+              calculateSpearmanCorrelationMatrixAsync(&data, &againstRows);
+    EXPECT_TRUE(pending.valid());
+    EXPECT_EQ(blocking, pending.get());
+    EXPECT_FALSE(pending.valid());
+
+    copy = data;
+    blocking = calculatePearsonCorrelationMatrix(&copy);
+    pending = calculatePearsonCorrelationMatrixAsync(&data);
+    pending.wait();
+    EXPECT_TRUE(pending.isReady());
+    EXPECT_EQ(blocking, pending.get());
+  }
+
+  setThreadCount(0);
+}
+
+
+TEST(ASYNC_RESULT, MANY_JOBS_OVERLAP){
+  setThreadCount(4);
+
+  csize_t numJobs = 6;
+  std::vector<std::vector<std::vector<double> > > inputs;
+  std::vector<std::vector<std::vector<double> > > expected;
+  for(size_t i = 0; i < numJobs; i++){
+    inputs.push_back(correlationTestData(60, 8, (f64) i));
+    expected.push_back(inputs.back());
+    calculateRankMatrix(expected.back());
+  }
+
+  std::atomic<size_t> reports(0);
+  std::vector<AsyncResult<bool> > pending;
+  for(size_t i = 0; i < numJobs; i++){
+    pending.push_back(calculateRankMatrixAsync(inputs[i], NULL,
+                                                countReports, &reports));
+  }
+
+  //The caller is free while the jobs run.
+  std::vector<std::vector<double> > meanwhile = correlationTestData(60, 8, 99);
+  EXPECT_EQ(60u, meanwhile.size());
+
+  for(size_t i = 0; i < numJobs; i++){
+    EXPECT_TRUE(pending[i].get());
+    EXPECT_EQ(expected[i], inputs[i]);
+  }
+  EXPECT_GE(reports.load(), 2 * numJobs);
+
+  setThreadCount(0);
+}
+
+
+TEST(ASYNC_RESULT, CANCELLED_AND_ABANDONED_JOBS){
+  setThreadCount(4);
+  std::vector<std::vector<double> > data = correlationTestData(80, 10, 0);
+
+  CancellationToken token;
+  token.cancel();
+  AsyncResult<std::vector<std::vector<double> > > cancelled =
+          calculateKendallsTauCorrelationCorrelationMatrixAsync(&data, NULL,
+                                                                &token);
+  EXPECT_TRUE(cancelled.get().empty());
+
+  //The caller's control is not carried into the job.
+  {
+    ParallelControl control(&token);
+    AsyncResult<bool> ranked = calculateRankMatrixAsync(data);
+    EXPECT_TRUE(ranked.get());
+  }
+
+  //Dropping a handle waits for its job.
+  std::atomic<bool> finished(false);
+  {
+    AsyncResult<int> dropped = runAsync<int>([&finished]{
+      finished = true;
+      return 1;
+    });
+  }
+  EXPECT_TRUE(finished.load());
+
+  AsyncResult<int> empty;
+  EXPECT_FALSE(empty.valid());
+  EXPECT_FALSE(empty.isReady());
+
+  setThreadCount(0);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
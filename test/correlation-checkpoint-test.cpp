@@ -0,0 +1,223 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <correlation-checkpoint.hpp>
+#include <correlation-matrix.hpp>
+#include <parallel-control.hpp>
+
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static const size_t rows = 37;
+static const size_t cols = 9;
+static const size_t tileSize = 8;
+
+
+static double referencePearson(const std::vector<double> &a,
+                                          const std::vector<double> &b){
+  double meanA = 0, meanB = 0;
+  for(size_t i = 0; i < a.size(); i++){
+    meanA += a[i];
+    meanB += b[i];
+  }
+  meanA /= (double) a.size();
+  meanB /= (double) b.size();
+
+  double ab = 0, aa = 0, bb = 0;
+  for(size_t i = 0; i < a.size(); i++){
+    ab += (a[i] - meanA) * (b[i] - meanB);
+    aa += (a[i] - meanA) * (a[i] - meanA);
+    bb += (b[i] - meanB) * (b[i] - meanB);
+  }
+  return ab / sqrt(aa * bb);
+}
+
+
+static std::string checkpointTestPath(){
+  return std::string(P_tmpdir) + "/madlib-checkpoint-test.ckpt";
+}
+
+
+//Cancels the token once enough checkpoint tiles are done.
+static void cancelAfterTiles(const char *stage, csize_t completed,
+                                          csize_t, void *context){
+  if(0 == strcmp(stage, "pearson checkpoint") && completed >= 5)
+    ((CancellationToken*) context)->cancel();
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(CORRELATION_CHECKPOINT, FULL_MATRIX_AND_RESUME){
+  const std::vector<std::vector<double> > original =
+                                            correlationTestData(rows, cols);
+  const std::string path = checkpointTestPath();
+  remove(path.c_str());
+
+  for(int run = 0; run < 2; run++){
+    std::vector<std::vector<double> > data = original;
+    std::vector<std::vector<double> > result =
+      calculatePearsonCorrelationMatrixCheckpointed(&data, path, nullptr,
+                                                              tileSize);
+    ASSERT_EQ(rows, result.size());
+    for(size_t y = 0; y < rows; y++){
+      for(size_t x = 0; x < rows; x++){
+        EXPECT_NEAR(result[y][x], referencePearson(original[y],
+                                                  original[x]), 1e-12);
+      }
+    }
+  }
+
+  remove(path.c_str());
+}
+
+
+TEST(CORRELATION_CHECKPOINT, AGAINST_ROWS){
+  const std::vector<std::vector<double> > original =
+                                            correlationTestData(rows, cols);
+  const std::vector<size_t> againstRows = {3, 20, 36, 3};
+  const std::string path = checkpointTestPath();
+
+  std::vector<std::vector<double> > data = original;
+  std::vector<std::vector<double> > result =
+    calculatePearsonCorrelationMatrixCheckpointed(&data, path,
+                                    &againstRows, tileSize, false);
+  ASSERT_EQ(againstRows.size(), result.size());
+  for(size_t p = 0; p < againstRows.size(); p++){
+    for(size_t x = 0; x < rows; x++){
+      EXPECT_NEAR(result[p][x], referencePearson(original[againstRows[p]],
+                                                  original[x]), 1e-12);
+    }
+  }
+
+  remove(path.c_str());
+}
+
+
+TEST(CORRELATION_CHECKPOINT, RESUME_AFTER_CANCEL){
+  const std::vector<std::vector<double> > original =
+                                            correlationTestData(rows, cols);
+  const std::string path = checkpointTestPath();
+  remove(path.c_str());
+
+  std::vector<std::vector<double> > data = original;
+  CancellationToken token;
+  {
+    ParallelControl control(&token, cancelAfterTiles, &token);
+    EXPECT_TRUE(calculatePearsonCorrelationMatrixCheckpointed(&data, path,
+                                              nullptr, tileSize).empty());
+  }
+  ASSERT_TRUE(token.isCancelled());
+  //The caller's rows are untouched, so the retry below hashes the same.
+  EXPECT_EQ(original, data);
+
+  //Mark a finished tile, so the retry shows whether it was reused.
+  size_t done = 0, marked = 0, markX = 0, markY = 0;
+  {
+    CorrelationCheckpoint checkpoint;
+    ASSERT_TRUE(checkpoint.open(path, rows, cols, tileSize,
+                                        hashExpressionData(data), true));
+    done = checkpoint.numberOfCompletedTiles();
+    while(marked < checkpoint.numberOfTiles()
+                            && !checkpoint.isTileComplete(marked)) marked++;
+    ASSERT_LT(marked, checkpoint.numberOfTiles());
+
+    std::vector<double> tile(tileSize * tileSize);
+    ASSERT_TRUE(checkpoint.readTile(marked, tile.data()));
+    std::pair<size_t, size_t> tileXY = checkpoint.tileCoordinates(marked);
+    markX = tileXY.first * tileSize + 1;
+    markY = tileXY.second * tileSize;
+    tile[1] = 7.0;
+    ASSERT_TRUE(checkpoint.writeTile(marked, tile.data()));
+  }
+  EXPECT_GE(done, (size_t) 5);
+  EXPECT_LT(done, (size_t) 15);
+
+  std::vector<std::vector<double> > result =
+    calculatePearsonCorrelationMatrixCheckpointed(&data, path, nullptr,
+                                                            tileSize);
+  ASSERT_EQ(rows, result.size());
+  EXPECT_EQ(7.0, result[markY][markX]);
+  for(size_t y = 0; y < rows; y++){
+    for(size_t x = 0; x < rows; x++){
+      if((y == markY && x == markX) || (x == markY && y == markX)) continue;
+      EXPECT_NEAR(result[y][x], referencePearson(original[y],
+                                                original[x]), 1e-12);
+    }
+  }
+
+  remove(path.c_str());
+}
+
+
+TEST(CORRELATION_CHECKPOINT, TILES_PERSIST){
+  const std::string path = checkpointTestPath();
+  std::vector<double> tile(tileSize * tileSize), readBack(tile.size());
+  for(size_t i = 0; i < tile.size(); i++) tile[i] = 0.5 * (double) i;
+
+  {
+    CorrelationCheckpoint checkpoint;
+    ASSERT_TRUE(checkpoint.open(path, rows, cols, tileSize, 42, false));
+    EXPECT_EQ((size_t) 15, checkpoint.numberOfTiles());
+    EXPECT_EQ(std::make_pair((size_t) 4, (size_t) 0),
+                                          checkpoint.tileCoordinates(4));
+    EXPECT_EQ(std::make_pair((size_t) 1, (size_t) 1),
+                                          checkpoint.tileCoordinates(5));
+    ASSERT_TRUE(checkpoint.writeTile(6, tile.data()));
+  }
+
+  {
+    CorrelationCheckpoint checkpoint;
+    ASSERT_TRUE(checkpoint.open(path, rows, cols, tileSize, 42, true));
+    EXPECT_EQ((size_t) 1, checkpoint.numberOfCompletedTiles());
+    EXPECT_TRUE(checkpoint.isTileComplete(6));
+    ASSERT_TRUE(checkpoint.readTile(6, readBack.data()));
+    EXPECT_EQ(tile, readBack);
+  }
+
+  {
+    //A different input must not pick up the old tiles.
+    CorrelationCheckpoint checkpoint;
+    ASSERT_TRUE(checkpoint.open(path, rows, cols, tileSize, 43, true));
+    EXPECT_EQ((size_t) 0, checkpoint.numberOfCompletedTiles());
+  }
+
+  remove(path.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
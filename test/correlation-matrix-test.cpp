@@ -1,4 +1,4 @@
-/*Copyright 2017 Josh Marshall*****************************************/
+/*Copyright 2017-2018 Josh Marshall********************************************/
 
 /***********************************************************************
     This file is part of "Marshall's  Datastructures and Algorithms".
@@ -19,37 +19,80 @@
     <http://www.gnu.org/licenses/>.
 ***********************************************************************/
 
-#ifndef KENDALL_CORRELATION_MATRIX_HPP
-#define KENDALL_CORRELATION_MATRIX_HPP
-
 ////////////////////////////////////////////////////////////////////////
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <vector>
+
 #include <correlation-matrix.hpp>
 
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
 ////////////////////////////////////////////////////////////////////////
-//PUBLIC FUNCTION DECLARATIONS /////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-/***********************************************************************
- * //TODO doc
- **********************************************************************/
-/*f64** calculateKendallsTauCorrelationCorrelationMatrix(
-                f64 **expressionData, csize_t numRows, csize_t numCols,
-            csize_t *againstRows = NULL, csize_t againstRowsLength = 0);
+static const size_t rows = 37;
+static const size_t cols = 9;
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
 
-f64** calculatePearsonCorrelationMatrix(f64 **expressionData,
-          csize_t numRows, csize_t numCols, csize_t *againstRows = NULL,
-                                        csize_t againstRowsLength = 0);
+TEST(CORRELATION_TRIANGLE, MATCHES_DENSE_MATRIX){
+  const std::vector<std::vector<double> > original =
+                                            correlationTestData(rows, cols);
 
+  std::vector<std::vector<double> > data = original;
+  UpperDiagonalSquareMatrix<f64> triangle =
+                            calculatePearsonCorrelationTriangle(&data);
+  data = original;
+  std::vector<std::vector<double> > dense =
+                            calculatePearsonCorrelationMatrix(&data);
 
-extern f64** calculateSpearmanCorrelationMatrix(f64 **expressionData,
-          csize_t numRows, csize_t numCols, csize_t *againstRows = NULL,
-                                          csize_t againstRowsLength = 0);*/
+  ASSERT_EQ(rows, triangle.getSideLength());
+  for(size_t y = 0; y < rows; y++)
+    for(size_t x = 0; x < rows; x++)
+      EXPECT_EQ(triangle.getValueAtIndex(x, y), dense[y][x]);
+
+  data = original;
+  triangle = calculateSpearmanCorrelationTriangle(&data);
+  dense = calculateSpearmanCorrelationMatrix(&data);
+  for(size_t y = 0; y < rows; y++){
+    EXPECT_EQ(data[y], original[y]);
+    for(size_t x = 0; x < rows; x++)
+      EXPECT_EQ(triangle.getValueAtIndex(x, y), dense[y][x]);
+  }
+}
+
+
+TEST(CORRELATION_TRIANGLE, PIPELINED_MATCHES_STAGED){
+  const std::vector<std::vector<double> > original =
+                                            correlationTestData(rows, cols);
+
+  for(int rankRows = 0; rankRows < 2; rankRows++){
+    std::vector<std::vector<double> > data = original;
+    UpperDiagonalSquareMatrix<f64> staged = rankRows
+                          ? calculateSpearmanCorrelationTriangle(&data)
+                          : calculatePearsonCorrelationTriangle(&data);
+
+    csize_t blockSizes[] = {1, 5, 8, 37, 256};
+    for(size_t b = 0; b < sizeof(blockSizes) / sizeof(blockSizes[0]); b++){
+      data = original;
+      UpperDiagonalSquareMatrix<f64> pipelined =
+        calculatePipelinedCorrelationTriangle(&data, rankRows,
+                                                        blockSizes[b]);
+      ASSERT_EQ(rows, pipelined.getSideLength());
+      for(size_t y = 0; y < rows; y++)
+        for(size_t x = y; x < rows; x++)
+          EXPECT_EQ(staged.getValueAtIndex(x, y),
+                                    pipelined.getValueAtIndex(x, y));
+    }
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
-
-#endif
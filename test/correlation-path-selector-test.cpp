@@ -0,0 +1,110 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string>
+
+#include <correlation-path-selector.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static correlationCostModel syntheticModel(){
+  correlationCostModel tr;
+  const size_t columns[COST_MODEL_SAMPLES] =
+                                    {4, 8, 16, 32, 64, 128, 256, 1024};
+  for(size_t i = 0; i < COST_MODEL_SAMPLES; i++){
+    tr.sampleColumns[i] = columns[i];
+    tr.pairCost[CORRELATION_KERNEL_PEARSON][i] = 2.0 + 0.5 * (f64) columns[i];
+    tr.pairCost[CORRELATION_KERNEL_KENDALL][i] = 4.0 + 2.0 * (f64) columns[i];
+  }
+  tr.triangleStoreCost = 1.0;
+  tr.extractionCost = 0.1;
+  return tr;
+}
+
+
+TEST(CORRELATION_PATH_SELECTOR, EXTREMES){
+  const correlationCostModel model = syntheticModel();
+
+  for(correlationKernel kernel : {CORRELATION_KERNEL_PEARSON,
+                                        CORRELATION_KERNEL_KENDALL}){
+    EXPECT_EQ(CORRELATION_PATH_CROSS_REFERENCE,
+              selectCorrelationPath(model, kernel, 20000, 32, 10, 8));
+    EXPECT_EQ(CORRELATION_PATH_BRUTE_FORCE,
+              selectCorrelationPath(model, kernel, 20000, 32, 20000, 8));
+    EXPECT_EQ(CORRELATION_PATH_BRUTE_FORCE,
+              selectCorrelationPath(model, kernel, 20000, 32, 15000, 8));
+  }
+}
+
+
+TEST(CORRELATION_PATH_SELECTOR, COST_GROWS_WITH_WORK){
+  const correlationCostModel model = syntheticModel();
+
+  for(correlationPath path : {CORRELATION_PATH_CROSS_REFERENCE,
+                                        CORRELATION_PATH_BRUTE_FORCE}){
+    const correlationKernel pearson = CORRELATION_KERNEL_PEARSON;
+    cf64 base = estimateCorrelationPathCost(model, pearson, path, 1000,
+                                                            16, 10, 4);
+    EXPECT_LT(base, estimateCorrelationPathCost(model, pearson, path,
+                                                      2000, 16, 10, 4));
+    EXPECT_LT(base, estimateCorrelationPathCost(model, pearson, path,
+                                                      1000, 300, 10, 4));
+    EXPECT_GT(base, estimateCorrelationPathCost(model, pearson, path,
+                                                      1000, 16, 10, 8));
+    EXPECT_LT(base, estimateCorrelationPathCost(model,
+                  CORRELATION_KERNEL_KENDALL, path, 1000, 16, 10, 4));
+  }
+}
+
+
+TEST(CORRELATION_PATH_SELECTOR, SAVE_AND_LOAD){
+  const correlationCostModel model = syntheticModel();
+  const std::string path = std::string(P_tmpdir)
+                     + "/madlib-selector-test/correlation-cost-model";
+  correlationCostModel loaded;
+
+  ASSERT_TRUE(saveCorrelationCostModel(path, model));
+  ASSERT_TRUE(loadCorrelationCostModel(path, loaded));
+
+  for(size_t i = 0; i < COST_MODEL_SAMPLES; i++){
+    EXPECT_EQ(model.sampleColumns[i], loaded.sampleColumns[i]);
+    for(size_t k = 0; k < CORRELATION_KERNELS; k++)
+      EXPECT_DOUBLE_EQ(model.pairCost[k][i], loaded.pairCost[k][i]);
+  }
+  EXPECT_DOUBLE_EQ(model.triangleStoreCost, loaded.triangleStoreCost);
+  EXPECT_DOUBLE_EQ(model.extractionCost, loaded.extractionCost);
+
+  remove(path.c_str());
+  EXPECT_FALSE(loadCorrelationCostModel(path, loaded));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
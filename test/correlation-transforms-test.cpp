@@ -0,0 +1,145 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <correlation-transforms.hpp>
+#include <statistics.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Enough values for the fast p-value path to build its table, spread
+//over (-1, 1) and including both ends.
+static std::vector<f64> makeCoefficients(){
+  std::vector<f64> tr(1 << 17);
+  for(size_t i = 0; i < tr.size(); i++)
+    tr[i] = -1 + 2.0 * (f64) i / (f64) (tr.size() - 1);
+  tr[tr.size() / 3] = 1e-12;
+  tr[tr.size() / 5] = NAN;
+  return tr;
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(CORRELATION_TRANSFORMS, FISHER_Z){
+  const std::vector<f64> r = makeCoefficients();
+  std::vector<f64> fast(r), exact(r);
+  transformCorrelations(fast.data(), fast.size(), 10,
+                                      CORRELATION_TO_FISHER_Z, false);
+  transformCorrelations(exact.data(), exact.size(), 10,
+                                      CORRELATION_TO_FISHER_Z, true);
+
+  EXPECT_EQ(fast.front(), -INFINITY);
+  EXPECT_EQ(fast.back(), INFINITY);
+  for(size_t i = 0; i < r.size(); i++){
+    if(isnan(r[i])){
+      EXPECT_TRUE(isnan(fast[i]));
+    }else if(fabs(r[i]) < 1){
+      EXPECT_NEAR(fast[i], atanh(r[i]), 1e-14 * fabs(atanh(r[i])));
+      EXPECT_DOUBLE_EQ(exact[i], atanh(r[i]));
+    }
+  }
+}
+
+
+TEST(CORRELATION_TRANSFORMS, T_STATISTIC){
+  std::vector<f64> values = {0, 0.5, -0.25, 1};
+  transformCorrelations(values.data(), values.size(), 12,
+                                    CORRELATION_TO_T_STATISTIC, false);
+  EXPECT_EQ(values[0], 0);
+  EXPECT_NEAR(values[1], 0.5 * sqrt(10 / 0.75), 1e-14);
+  EXPECT_NEAR(values[2], -0.25 * sqrt(10 / 0.9375), 1e-14);
+  EXPECT_EQ(values[3], INFINITY);
+}
+
+
+TEST(CORRELATION_TRANSFORMS, P_VALUE_FAST_MATCHES_EXACT){
+  const std::vector<f64> r = makeCoefficients();
+
+  for(size_t numSamples : {3, 8, 50, 1000}){
+    std::vector<f64> fast(r), exact(r);
+    transformCorrelations(fast.data(), fast.size(), numSamples,
+                                        CORRELATION_TO_P_VALUE, false);
+    transformCorrelations(exact.data(), exact.size(), numSamples,
+                                        CORRELATION_TO_P_VALUE, true);
+
+    for(size_t i = 0; i < r.size(); i++){
+      if(isnan(r[i])){
+        EXPECT_TRUE(isnan(fast[i]));
+        continue;
+      }
+      //Exact against the t distribution, whose df / (df + t^2) loses
+      //the tiny coefficients.
+      cf64 df = (f64) (numSamples - 2);
+      cf64 t = r[i] * sqrt(df / ((1 - r[i]) * (1 + r[i])));
+      if(fabs(r[i]) < 1 && fabs(r[i]) > 1e-6){
+        EXPECT_NEAR(exact[i], getStudentTPValue(t, df),
+                                                    1e-11 * exact[i]);
+      }
+      //Fast against exact; tiny values may flush to 0 differently.
+      if(exact[i] > 1e-290){
+        EXPECT_NEAR(fast[i], exact[i], 2 * CORRELATION_P_VALUE_TOLERANCE
+                                                          * exact[i]);
+      }else{
+        EXPECT_LE(fast[i], 1e-280);
+      }
+    }
+  }
+}
+
+
+TEST(CORRELATION_TRANSFORMS, MATRIX_AND_DEGENERATE_SAMPLES){
+  UpperDiagonalSquareMatrix<f64> matrix(4);
+  matrix.fill(0.3);
+  for(size_t i = 0; i < 4; i++) matrix.setValueAtIndex(i, i, 1);
+
+  transformCorrelationMatrix(matrix, 20, CORRELATION_TO_P_VALUE, false);
+  for(size_t y = 0; y < 4; y++){
+    for(size_t x = y; x < 4; x++){
+      if(x == y){
+        EXPECT_EQ(matrix.getValueAtIndex(x, y), 0);
+      }else{
+        EXPECT_NEAR(matrix.getValueAtIndex(x, y),
+            regularizedIncompleteBeta(9, 0.5, 1 - 0.09), 1e-14);
+      }
+    }
+  }
+
+  std::vector<f64> values = {0.5};
+  transformCorrelations(values.data(), 1, 2, CORRELATION_TO_P_VALUE,
+                                                                false);
+  EXPECT_TRUE(isnan(values[0]));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
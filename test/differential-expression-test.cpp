@@ -0,0 +1,173 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <differential-expression.hpp>
+#include <statistics.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Groups are interleaved so the gather step is exercised.
+static const std::vector<size_t> labels = {0, 1, 2, 0, 1, 2, 0, 1, 0, 2, 1};
+
+static std::vector<std::vector<double> > makeData(){
+  std::vector<std::vector<double> > tr(20, std::vector<double>(11));
+  for(size_t y = 0; y < tr.size(); y++)
+    for(size_t x = 0; x < labels.size(); x++)
+      tr[y][x] = 1e4 + sin((f64) y * 3.1 + (f64) x * 1.7)
+                                          + 0.1 * (f64) (y * labels[x]);
+  return tr;
+}
+
+
+//Means and sums of squared deviations of each group of a row, computed
+//the long way.
+static void groupMoments(const std::vector<double> &row,
+                              const std::vector<size_t> &groups,
+        csize_t numGroups, std::vector<f64> &mean, std::vector<f64> &ss,
+                                              std::vector<f64> &count){
+  mean.assign(numGroups, 0);
+  ss.assign(numGroups, 0);
+  count.assign(numGroups, 0);
+  for(size_t x = 0; x < row.size(); x++){
+    mean[groups[x]] += row[x];
+    count[groups[x]]++;
+  }
+  for(size_t g = 0; g < numGroups; g++) mean[g] /= count[g];
+  for(size_t x = 0; x < row.size(); x++){
+    cf64 d = row[x] - mean[groups[x]];
+    ss[groups[x]] += d * d;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(DIFFERENTIAL_EXPRESSION, T_TESTS){
+  std::vector<std::vector<double> > data = makeData();
+  std::vector<size_t> twoGroups(labels);
+  for(size_t x = 0; x < twoGroups.size(); x++) twoGroups[x] %= 2;
+
+  groupTestResults student = calculateGroupTests(data, twoGroups,
+                                                        STUDENT_T_TEST);
+  groupTestResults welch = calculateGroupTests(data, twoGroups,
+                                                          WELCH_T_TEST);
+  ASSERT_EQ(student.statistic.size(), data.size());
+  ASSERT_EQ(welch.statistic.size(), data.size());
+
+  for(size_t y = 0; y < data.size(); y++){
+    std::vector<f64> mean, ss, n;
+    groupMoments(data[y], twoGroups, 2, mean, ss, n);
+
+    cf64 df = n[0] + n[1] - 2;
+    cf64 t = (mean[0] - mean[1])
+                    / sqrt((ss[0] + ss[1]) / df * (1 / n[0] + 1 / n[1]));
+    EXPECT_NEAR(student.statistic[y], t, 1e-7);
+    EXPECT_EQ(student.degreesOfFreedom[y], df);
+    EXPECT_NEAR(student.pValue[y], getStudentTPValue(t, df), 1e-9);
+
+    cf64 v0 = ss[0] / (n[0] - 1) / n[0], v1 = ss[1] / (n[1] - 1) / n[1];
+    cf64 welchT = (mean[0] - mean[1]) / sqrt(v0 + v1);
+    cf64 welchDf = (v0 + v1) * (v0 + v1)
+                      / (v0 * v0 / (n[0] - 1) + v1 * v1 / (n[1] - 1));
+    EXPECT_NEAR(welch.statistic[y], welchT, 1e-7);
+    EXPECT_NEAR(welch.degreesOfFreedom[y], welchDf, 1e-7);
+    EXPECT_NEAR(welch.pValue[y], getStudentTPValue(welchT, welchDf), 1e-9);
+  }
+}
+
+
+TEST(DIFFERENTIAL_EXPRESSION, ONE_WAY_ANOVA){
+  std::vector<std::vector<double> > data = makeData();
+  groupTestResults anova = calculateGroupTests(data, labels, ONE_WAY_ANOVA);
+  ASSERT_EQ(anova.statistic.size(), data.size());
+
+  for(size_t y = 0; y < data.size(); y++){
+    std::vector<f64> mean, ss, n;
+    groupMoments(data[y], labels, 3, mean, ss, n);
+
+    cf64 numCols = (f64) labels.size();
+    cf64 grand = (mean[0]*n[0] + mean[1]*n[1] + mean[2]*n[2]) / numCols;
+    f64 between = 0, within = 0;
+    for(size_t g = 0; g < 3; g++){
+      between += n[g] * (mean[g] - grand) * (mean[g] - grand);
+      within += ss[g];
+    }
+    cf64 f = (between / 2) / (within / (numCols - 3));
+
+    EXPECT_NEAR(anova.statistic[y], f, 1e-6 * f);
+    EXPECT_EQ(anova.degreesOfFreedom[y], labels.size() - 3);
+    EXPECT_NEAR(anova.pValue[y], getFPValue(f, 2, numCols - 3), 1e-8);
+  }
+}
+
+
+TEST(DIFFERENTIAL_EXPRESSION, ANOVA_SKIPS_UNUSED_LABELS){
+  std::vector<std::vector<double> > data = makeData();
+  std::vector<size_t> gapped(labels.size());
+  for(size_t x = 0; x < labels.size(); x++) gapped[x] = labels[x] * 2;
+
+  groupTestResults dense = calculateGroupTests(data, labels, ONE_WAY_ANOVA);
+  groupTestResults sparse = calculateGroupTests(data, gapped, ONE_WAY_ANOVA);
+  ASSERT_EQ(dense.statistic.size(), sparse.statistic.size());
+
+  for(size_t y = 0; y < data.size(); y++){
+    EXPECT_NEAR(dense.statistic[y], sparse.statistic[y],
+                                            1e-9 * dense.statistic[y]);
+    EXPECT_EQ(dense.degreesOfFreedom[y], sparse.degreesOfFreedom[y]);
+    EXPECT_NEAR(dense.pValue[y], sparse.pValue[y], 1e-12);
+  }
+
+  //Only one group actually present.
+  EXPECT_TRUE(calculateGroupTests(data, std::vector<size_t>(11, 2),
+                                      ONE_WAY_ANOVA).statistic.empty());
+}
+
+
+TEST(DIFFERENTIAL_EXPRESSION, BAD_INPUT){
+  std::vector<std::vector<double> > data = makeData();
+  EXPECT_TRUE(calculateGroupTests(data, labels, WELCH_T_TEST)
+                                                    .statistic.empty());
+  EXPECT_TRUE(calculateGroupTests(data, std::vector<size_t>(3, 0),
+                                      ONE_WAY_ANOVA).statistic.empty());
+
+  std::vector<std::vector<double> > constant(2, {1, 1, 1, 1});
+  groupTestResults r = calculateGroupTests(constant, {0, 0, 1, 1},
+                                                        STUDENT_T_TEST);
+  ASSERT_EQ(r.statistic.size(), 2u);
+  EXPECT_TRUE(isnan(r.statistic[0]));
+  EXPECT_TRUE(isnan(r.pValue[1]));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
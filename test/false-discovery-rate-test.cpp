@@ -0,0 +1,154 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#include <false-discovery-rate.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Mostly uniform nulls, some strong signals, and deliberate ties.
+static std::vector<f64> makePValues(csize_t count){
+  std::vector<f64> tr(count);
+  u64 state = 88172645463325252ULL;
+  for(size_t i = 0; i < count; i++){
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    cf64 uniform = (f64) (state >> 11) * (1.0 / 9007199254740992.0);
+    if(0 == i % 10) tr[i] = uniform * 1e-4;
+    else if(0 == i % 37) tr[i] = 0.001;
+    else tr[i] = uniform;
+  }
+  return tr;
+}
+
+
+//Textbook BH by sorting.
+static f64 sortedThreshold(std::vector<f64> pValues, cf64 q){
+  std::vector<f64> kept;
+  for(size_t i = 0; i < pValues.size(); i++)
+    if(!isnan(pValues[i])) kept.push_back(pValues[i]);
+  std::sort(kept.begin(), kept.end());
+
+  f64 tr = -1;
+  for(size_t k = 0; k < kept.size(); k++)
+    if((f64) (k + 1) * q / (f64) kept.size() >= kept[k]) tr = kept[k];
+  return tr;
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(FALSE_DISCOVERY_RATE, MATCHES_SORTED_BH){
+  std::vector<f64> pValues = makePValues(200000);
+  pValues[5] = NAN;
+
+  for(f64 q : {0.001, 0.01, 0.05, 0.2, 1.0}){
+    cf64 expected = sortedThreshold(pValues, q);
+    EXPECT_EQ(getBenjaminiHochbergThreshold(pValues.data(),
+                                          pValues.size(), q), expected);
+  }
+}
+
+
+//Tiny histograms and gather limit force several refining passes, fed
+//in uneven chunks from separate copies as a sharded reader would.
+TEST(FALSE_DISCOVERY_RATE, REFINES_IN_CHUNKS){
+  const std::vector<f64> pValues = makePValues(50000);
+  const size_t cuts[] = {0, 7, 20000, 20001, 50000};
+  cf64 q = 0.05;
+
+  BenjaminiHochbergThreshold bh(q, 16, 8);
+  size_t passes = 0;
+  while(!bh.isResolved()){
+    bh.beginPass();
+    std::vector<BenjaminiHochbergThreshold> parts(4, bh);
+    for(size_t c = 0; c < 4; c++)
+      parts[c].add(pValues.data() + cuts[c], cuts[c+1] - cuts[c]);
+    for(size_t c = 0; c < 4; c++) bh.merge(parts[c]);
+    bh.endPass();
+    passes++;
+  }
+
+  EXPECT_GT(passes, 2u);
+  EXPECT_EQ(bh.getNumberOfTests(), pValues.size());
+  EXPECT_EQ(bh.getThreshold(), sortedThreshold(pValues, q));
+}
+
+
+TEST(FALSE_DISCOVERY_RATE, NOTHING_REJECTED){
+  std::vector<f64> pValues(1000, 0.9);
+  EXPECT_LT(getBenjaminiHochbergThreshold(pValues.data(), 1000, 0.05), 0);
+  EXPECT_LT(getBenjaminiHochbergThreshold(pValues.data(), 0, 0.05), 0);
+}
+
+
+TEST(FALSE_DISCOVERY_RATE, MATRIX_SKIPS_DIAGONAL){
+  const size_t n = 300;
+  const std::vector<f64> source = makePValues(n * n);
+  UpperDiagonalSquareMatrix<f64> matrix(n);
+  std::vector<f64> pairs;
+  for(size_t y = 0; y < n; y++){
+    matrix.setValueAtIndex(y, y, 0);
+    for(size_t x = y + 1; x < n; x++){
+      matrix.setValueAtIndex(x, y, source[y * n + x]);
+      pairs.push_back(source[y * n + x]);
+    }
+  }
+
+  cf64 threshold = getBenjaminiHochbergThreshold(matrix, 0.05);
+  EXPECT_EQ(threshold, sortedThreshold(pairs, 0.05));
+  ASSERT_GE(threshold, 0);
+
+  UpperDiagonalSquareMatrix<u8> rejected(n);
+  csize_t count = markBenjaminiHochbergRejections(matrix, threshold,
+                                                              rejected);
+  size_t expected = 0;
+  for(size_t i = 0; i < pairs.size(); i++) expected += pairs[i] <= threshold;
+  EXPECT_EQ(count, expected);
+  for(size_t y = 0; y < n; y++){
+    EXPECT_EQ(rejected.getValueAtIndex(y, y), 0);
+    for(size_t x = y + 1; x < n; x++){
+      EXPECT_EQ(rejected.getValueAtIndex(x, y),
+                              matrix.getValueAtIndex(x, y) <= threshold);
+    }
+  }
+
+  std::vector<u8> flags(pairs.size());
+  EXPECT_EQ(markBenjaminiHochbergRejections(pairs.data(), pairs.size(),
+                                  threshold, flags.data()), expected);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
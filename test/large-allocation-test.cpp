@@ -0,0 +1,95 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <large-allocation.hpp>
+#include <upper-diagonal-square-matrix.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(LargeAllocation, smallAndLargeAreUsable){
+  csize_t sizes[] = {1, 4096, (2 << 20) - 1, (2 << 20) + 17, 9 << 20};
+
+  for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++){
+    u8 *memory = (u8*) allocateLarge(sizes[i]);
+    ASSERT_TRUE(NULL != memory);
+    memset(memory, 0xA5, sizes[i]);
+    firstTouchZero(memory, sizes[i]);
+    for(size_t j = 0; j < sizes[i]; j += 4093)
+      EXPECT_EQ(0, memory[j]);
+    EXPECT_EQ(0, memory[sizes[i]-1]);
+    free(memory);
+  }
+}
+
+
+TEST(LargeAllocation, largeIsHugePageAligned){
+  if(!hugePagesEnabled()) return;
+  void *memory = allocateLarge(5 << 20);
+  ASSERT_TRUE(NULL != memory);
+  EXPECT_EQ(0u, ((uintptr_t) memory) % (2 << 20));
+  free(memory);
+}
+
+
+TEST(LargeAllocation, distributeRowsKeepsContents){
+  std::vector<std::vector<double> > data(37);
+  for(size_t y = 0; y < data.size(); y++)
+    for(size_t x = 0; x < y + 3; x++)
+      data[y].push_back((double) y * 1000.0 + (double) x);
+
+  distributeRows(data);
+
+  ASSERT_EQ(37u, data.size());
+  for(size_t y = 0; y < data.size(); y++){
+    ASSERT_EQ(y + 3, data[y].size());
+    for(size_t x = 0; x < data[y].size(); x++)
+      EXPECT_EQ((double) y * 1000.0 + (double) x, data[y][x]);
+  }
+}
+
+
+TEST(LargeAllocation, matrixZeroDataClearsEveryElement){
+  //Large enough to take the parallel path.
+  UpperDiagonalSquareMatrix<f64> matrix(1200);
+  matrix.fill(3.0);
+  matrix.zeroData();
+  for(size_t y = 0; y < 1200; y += 7)
+    for(size_t x = y; x < 1200; x += 11)
+      EXPECT_EQ(0.0, matrix.getValueAtIndex(x, y));
+  EXPECT_EQ(0.0, matrix.getValueAtIndex(1199, 1199));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,66 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <short-primatives.h>
+
+////////////////////////////////////////////////////////////////////////
+//TEST DATA/////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Rows which are smooth but far from collinear, with small periodic
+//bumps so no two rows correlate exactly.  A different phase gives a
+//different data set of the same shape.
+inline std::vector<std::vector<double> > correlationTestData(
+                      csize_t rows, csize_t cols, cf64 phase = 0){
+  std::vector<std::vector<double> > tr(rows, std::vector<double>(cols));
+  for(size_t y = 0; y < rows; y++)
+    for(size_t x = 0; x < cols; x++)
+      tr[y][x] = sin(0.7 * (f64) y + 1.3 * (f64) x + phase)
+                                          + 0.01 * (f64) ((x * y) % 5);
+  return tr;
+}
+
+
+//Value at (x, y) of a test triangle, in [-1, 1] and varying along both
+//rows and columns.
+inline f64 triangleTestValue(csize_t x, csize_t y){
+  return sin(0.37 * (f64) x + 1.91 * (f64) y);
+}
+
+
+//As triangleTestValue(), but 1 on the diagonal like a correlation
+//matrix.
+inline f64 unitDiagonalTestValue(csize_t x, csize_t y){
+  return x == y ? 1.0 : triangleTestValue(x, y);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,141 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <online-statistics.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static std::vector<f64> makeSeries(csize_t size, cf64 offset, cf64 phase){
+  std::vector<f64> tr(size);
+  for(size_t i = 0; i < size; i++)
+    tr[i] = offset + sin((f64) i * 0.7 + phase) * (f64) (1 + i % 5);
+  return tr;
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(ONLINE_STATISTICS, MOMENTS_MERGE_MATCHES_SINGLE_PASS){
+  const std::vector<f64> data = makeSeries(101, 1e7, 0.2);
+
+  OnlineMoments whole;
+  whole.push(data.data(), data.size());
+
+  //Uneven chunks, including an empty one, merged in a tree.
+  const size_t cuts[] = {0, 0, 3, 40, 41, 101};
+  std::vector<OnlineMoments> parts(5);
+  for(size_t p = 0; p < parts.size(); p++)
+    parts[p].push(data.data() + cuts[p], cuts[p+1] - cuts[p]);
+  parts[0].merge(parts[1]);
+  parts[2].merge(parts[3]);
+  parts[2].merge(parts[4]);
+  parts[0].merge(parts[2]);
+
+  EXPECT_EQ(parts[0].getCount(), whole.getCount());
+  EXPECT_NEAR(parts[0].getMean(), whole.getMean(), 1e-6);
+  EXPECT_NEAR(parts[0].getVariance(), whole.getVariance(), 1e-8);
+  EXPECT_NEAR(parts[0].getSkewness(), whole.getSkewness(), 1e-8);
+  EXPECT_NEAR(parts[0].getKurtosis(), whole.getKurtosis(), 1e-8);
+  EXPECT_EQ(parts[0].getMinimum(), whole.getMinimum());
+  EXPECT_EQ(parts[0].getMaximum(), whole.getMaximum());
+
+  //Check against the textbook two pass definitions.
+  f64 mean = 0;
+  for(size_t i = 0; i < data.size(); i++) mean += data[i] - 1e7;
+  mean = 1e7 + mean / (f64) data.size();
+  f64 m2 = 0, m3 = 0, m4 = 0;
+  for(size_t i = 0; i < data.size(); i++){
+    cf64 d = data[i] - mean;
+    m2 += d * d;
+    m3 += d * d * d;
+    m4 += d * d * d * d;
+  }
+  csize_t n = data.size();
+  EXPECT_NEAR(whole.getVariance(), m2 / (f64) (n - 1), 1e-8);
+  EXPECT_NEAR(whole.getSkewness(), sqrt((f64) n) * m3 / pow(m2, 1.5), 1e-8);
+  EXPECT_NEAR(whole.getKurtosis(), (f64) n * m4 / (m2 * m2) - 3, 1e-8);
+}
+
+
+TEST(ONLINE_STATISTICS, MOMENTS_EMPTY_AND_NAN){
+  OnlineMoments moments;
+  EXPECT_TRUE(isnan(moments.getMean()));
+  EXPECT_TRUE(isnan(moments.getVariance()));
+
+  moments.push(NAN);
+  moments.push(2);
+  EXPECT_EQ(moments.getCount(), 1u);
+  EXPECT_EQ(moments.getNanCount(), 1u);
+  EXPECT_EQ(moments.getMean(), 2);
+  EXPECT_TRUE(isnan(moments.getVariance()));
+
+  OnlineMoments other;
+  other.push(NAN);
+  other.merge(moments);
+  EXPECT_EQ(other.getNanCount(), 2u);
+  EXPECT_EQ(other.getMean(), 2);
+}
+
+
+TEST(ONLINE_STATISTICS, COVARIANCE_MERGE_MATCHES_SINGLE_PASS){
+  const std::vector<f64> x = makeSeries(77, 5e6, 0.0);
+  const std::vector<f64> y = makeSeries(77, -3e5, 1.3);
+
+  OnlineCovariance whole;
+  whole.push(x.data(), y.data(), x.size());
+
+  OnlineCovariance left, right;
+  left.push(x.data(), y.data(), 30);
+  right.push(x.data() + 30, y.data() + 30, x.size() - 30);
+  left.merge(right);
+
+  EXPECT_EQ(left.getCount(), x.size());
+  EXPECT_NEAR(left.getMeanX(), whole.getMeanX(), 1e-6);
+  EXPECT_NEAR(left.getMeanY(), whole.getMeanY(), 1e-6);
+  EXPECT_NEAR(left.getCovariance(), whole.getCovariance(), 1e-8);
+  EXPECT_NEAR(left.getCorrelation(), whole.getCorrelation(), 1e-9);
+
+  f64 sxy = 0, sxx = 0, syy = 0;
+  for(size_t i = 0; i < x.size(); i++){
+    cf64 dx = x[i] - whole.getMeanX(), dy = y[i] - whole.getMeanY();
+    sxy += dx * dy;
+    sxx += dx * dx;
+    syy += dy * dy;
+  }
+  EXPECT_NEAR(whole.getCovariance(), sxy / (f64) (x.size() - 1), 1e-8);
+  EXPECT_NEAR(whole.getCorrelation(), sxy / sqrt(sxx * syy), 1e-9);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,205 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <string.h>
+#include <vector>
+
+#include <correlation-matrix.hpp>
+#include <parallel-control.hpp>
+#include <parallel-for.hpp>
+#include <rank-matrix.hpp>
+#include <simple-thread-dispatch.hpp>
+#include <task-graph.hpp>
+
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct progressLog{
+  const char *stage;
+  size_t reports;
+  size_t lastCompleted;
+  size_t lastTotal;
+  bool wentBackwards;
+  size_t cancelAfter;
+  CancellationToken *token;
+};
+
+
+static void logProgress(const char *stage, csize_t completed,
+                                          csize_t total, void *context){
+  progressLog *log = (progressLog*) context;
+  if(NULL == log->stage || 0 != strcmp(stage, log->stage)) return;
+
+  log->wentBackwards |= log->reports > 0 && completed < log->lastCompleted;
+  log->reports++;
+  log->lastCompleted = completed;
+  log->lastTotal = total;
+  if(NULL != log->token && completed >= log->cancelAfter)
+    log->token->cancel();
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(PARALLEL_CONTROL, CARRIED_TO_WORKERS){
+  setThreadCount(4);
+  EXPECT_EQ(NULL, currentParallelControl());
+  EXPECT_FALSE(parallelCancelled());
+
+  CancellationToken token;
+  std::atomic<size_t> missing(0);
+  {
+    ParallelControl control(&token);
+    parallelFor(0, 1000, 10, [&](csize_t, csize_t){
+      if(&control != currentParallelControl()) missing++;
+    });
+    EXPECT_EQ(&control, currentParallelControl());
+  }
+  EXPECT_EQ(0u, missing.load());
+  EXPECT_EQ(NULL, currentParallelControl());
+
+  setThreadCount(0);
+}
+
+
+TEST(PARALLEL_CONTROL, PROGRESS_REACHES_TOTAL){
+  setThreadCount(4);
+  std::vector<std::vector<double> > data = correlationTestData(300, 12);
+
+  progressLog log = {"pearson brute force", 0, 0, 0, false, 0, NULL};
+  {
+    ParallelControl control(NULL, logProgress, &log);
+    UpperDiagonalSquareMatrix<f64> triangle =
+                              calculatePearsonCorrelationTriangle(&data);
+    EXPECT_EQ(triangle.numberOfElements(), log.lastTotal);
+  }
+  EXPECT_GT(log.reports, 4u);
+  EXPECT_EQ(log.lastTotal, log.lastCompleted);
+  EXPECT_FALSE(log.wentBackwards);
+
+  progressLog rankLog = {"rank", 0, 0, 0, false, 0, NULL};
+  {
+    ParallelControl control(NULL, logProgress, &rankLog);
+    calculateRankMatrix(data);
+  }
+  EXPECT_EQ(300u, rankLog.lastTotal);
+  EXPECT_EQ(300u, rankLog.lastCompleted);
+
+  setThreadCount(0);
+}
+
+
+TEST(PARALLEL_CONTROL, CANCELLED_CALLS_RETURN_EMPTY){
+  setThreadCount(4);
+  std::vector<std::vector<double> > data = correlationTestData(100, 12);
+  std::vector<size_t> againstRows = {3, 50, 7};
+
+  CancellationToken token;
+  token.cancel();
+  {
+    ParallelControl control(&token);
+    EXPECT_TRUE(parallelCancelled());
+    EXPECT_TRUE(calculatePearsonCorrelationMatrix(&data).empty());
+    EXPECT_TRUE(calculatePearsonCorrelationMatrix(&data,
+                                                    &againstRows).empty());
+    EXPECT_TRUE(calculateSpearmanCorrelationMatrix(&data).empty());
+    EXPECT_TRUE(calculateKendallsTauCorrelationCorrelationMatrix(
+                                                          &data).empty());
+    EXPECT_EQ(0u, calculateSpearmanCorrelationTriangle(&data)
+                                                  .numberOfElements());
+  }
+
+  //Without the control the same token no longer applies.
+  EXPECT_FALSE(parallelCancelled());
+  token.reset();
+  {
+    ParallelControl control(&token);
+    EXPECT_EQ(100u, calculatePearsonCorrelationMatrix(&data).size());
+  }
+
+  setThreadCount(0);
+}
+
+
+TEST(PARALLEL_CONTROL, CANCEL_PART_WAY_STOPS_EARLY){
+  setThreadCount(4);
+  std::vector<std::vector<double> > data = correlationTestData(1024, 12);
+
+  CancellationToken token;
+  progressLog log = {"pearson pipeline", 0, 0, 0, false, 10, &token};
+  {
+    ParallelControl control(&token, logProgress, &log);
+    UpperDiagonalSquareMatrix<f64> triangle =
+                calculatePipelinedCorrelationTriangle(&data, false, 32);
+    EXPECT_EQ(0u, triangle.numberOfElements());
+  }
+  EXPECT_TRUE(token.isCancelled());
+  EXPECT_EQ((32u * 33u) / 2, log.lastTotal);
+  EXPECT_LT(log.lastCompleted, log.lastTotal);
+
+  setThreadCount(0);
+}
+
+
+TEST(PARALLEL_CONTROL, PRIMITIVES_IGNORE_CANCEL){
+  setThreadCount(4);
+
+  CancellationToken token;
+  token.cancel();
+  {
+    ParallelControl control(&token);
+    csize_t grains[] = {0, 7};
+    for(size_t g = 0; g < 2; g++){
+      std::atomic<size_t> seen(0);
+      parallelFor(0, 1000, grains[g], [&seen](csize_t first, csize_t last){
+        seen += last - first;
+      });
+      EXPECT_EQ(1000u, seen.load());
+
+      EXPECT_EQ(1000u, parallelReduce(0, 1000, grains[g], (size_t) 0,
+                  [](csize_t first, csize_t last){ return last - first; },
+                  [](csize_t left, csize_t right){ return left + right; }));
+    }
+
+    std::atomic<size_t> ran(0);
+    TaskGraph graph;
+    csize_t first = graph.addTask([&ran]{ ran++; });
+    graph.addDependency(first, graph.addTask([&ran]{ ran++; }));
+    EXPECT_TRUE(graph.run());
+    EXPECT_EQ(2u, ran.load());
+  }
+
+  setThreadCount(0);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,95 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <vector>
+
+#include <parallel-for.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(PARALLEL_FOR, EVERY_INDEX_ONCE){
+  csize_t grains[] = {0, 1, 7, 1000, 5000};
+
+  for(size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++){
+    std::vector<std::atomic<size_t> > seen(3000);
+    parallelFor(17, 3000, grains[g], [&seen](csize_t first, csize_t last){
+      for(size_t i = first; i < last; i++) seen[i]++;
+    });
+
+    for(size_t i = 0; i < seen.size(); i++)
+      ASSERT_EQ(i < 17 ? 0u : 1u, seen[i].load()) << grains[g];
+  }
+
+  size_t calls = 0;
+  parallelFor(5, 5, 0, [&calls](csize_t, csize_t){ calls++; });
+  EXPECT_EQ(0u, calls);
+}
+
+
+TEST(PARALLEL_FOR, REDUCE){
+  std::vector<f64> values(10007);
+  for(size_t i = 0; i < values.size(); i++) values[i] = 1.0 / (f64) (i+1);
+
+  f64 expected = 0;
+  for(size_t i = 0; i < values.size(); i++) expected += values[i];
+
+  auto sum = [&values](csize_t first, csize_t last){
+    f64 tr = 0;
+    for(size_t i = first; i < last; i++) tr += values[i];
+    return tr;
+  };
+  auto add = [](f64 left, f64 right){ return left + right; };
+
+  csize_t grains[] = {0, 1, 64, 20000};
+  for(size_t g = 0; g < sizeof(grains) / sizeof(grains[0]); g++){
+    f64 result = parallelReduce(0, values.size(), grains[g], 0.0, sum, add);
+    EXPECT_NEAR(expected, result, 1e-9);
+    //Chunks combine in order, so repeating gives the same bits.
+    EXPECT_EQ(result,
+              parallelReduce(0, values.size(), grains[g], 0.0, sum, add));
+  }
+
+  //Order of combination is preserved for non-commutative operations.
+  std::vector<size_t> order = parallelReduce(0, 50, 3,
+    std::vector<size_t>(),
+    [](csize_t first, csize_t){ return std::vector<size_t>(1, first); },
+    [](std::vector<size_t> left, const std::vector<size_t> &right){
+      left.insert(left.end(), right.begin(), right.end());
+      return left;
+    });
+  ASSERT_EQ(17u, order.size());
+  for(size_t i = 0; i < order.size(); i++) EXPECT_EQ(i * 3, order[i]);
+
+  EXPECT_EQ(-1.0, parallelReduce(3, 3, 0, -1.0, sum, add));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,150 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <parallel-for.hpp>
+#include <parallel-profile.hpp>
+#include <simple-thread-dispatch.hpp>
+#include <task-graph.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//PRIVATE FUNCTION DEFINITIONS//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static const parallelRegionProfile *findRegion(
+        const std::vector<parallelRegionProfile> &profile, const char *name){
+  for(size_t i = 0; i < profile.size(); i++)
+    if(profile[i].name == name) return &profile[i];
+  return NULL;
+}
+
+
+static u64 totalItems(const parallelRegionProfile &region){
+  u64 tr = 0;
+  for(size_t i = 0; i < region.items.size(); i++) tr += region.items[i];
+  return tr;
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(PARALLEL_PROFILE, RECORDS_SHARES_AND_ITEMS){
+  setThreadCount(4);
+  setParallelProfiling(true);
+  resetParallelProfile();
+
+  std::vector<f64> values(10000, 1);
+  for(int launch = 0; launch < 3; launch++){
+    ParallelRegion region("test scale");
+    parallelFor(0, values.size(), 0, [&](csize_t first, csize_t last){
+      for(size_t i = first; i < last; i++) values[i] *= 2;
+    });
+  }
+  {
+    ParallelRegion region("test chunks");
+    parallelFor(0, values.size(), 64, [&](csize_t first, csize_t last){
+      for(size_t i = first; i < last; i++) values[i] += 1;
+    });
+  }
+
+  std::vector<parallelRegionProfile> profile = getParallelProfile();
+  const parallelRegionProfile *scale = findRegion(profile, "test scale");
+  const parallelRegionProfile *chunks = findRegion(profile, "test chunks");
+  ASSERT_NE((void*) NULL, scale);
+  ASSERT_NE((void*) NULL, chunks);
+
+  EXPECT_EQ(3u, scale->launches);
+  EXPECT_EQ(4u, scale->busySeconds.size());
+  EXPECT_EQ(3 * values.size(), totalItems(*scale));
+  for(size_t i = 0; i < scale->items.size(); i++)
+    EXPECT_EQ(3 * values.size() / 4, scale->items[i]);
+  EXPECT_EQ(1u, chunks->launches);
+  EXPECT_EQ(values.size(), totalItems(*chunks));
+  EXPECT_EQ(NULL, findRegion(profile, "unnamed"));
+
+  FILE *report = tmpfile();
+  ASSERT_NE((FILE*) NULL, report);
+  printParallelProfile(report);
+  rewind(report);
+  char line[256];
+  std::string text;
+  while(NULL != fgets(line, sizeof(line), report)) text += line;
+  fclose(report);
+  EXPECT_NE(std::string::npos, text.find("imbalance"));
+  EXPECT_NE(std::string::npos, text.find("test scale"));
+
+  resetParallelProfile();
+  EXPECT_TRUE(getParallelProfile().empty());
+
+  setParallelProfiling(false);
+  setThreadCount(0);
+}
+
+
+TEST(PARALLEL_PROFILE, TASK_GRAPHS_COUNT_TASKS){
+  setParallelProfiling(true);
+  resetParallelProfile();
+
+  TaskGraph graph;
+  for(size_t i = 0; i < 20; i++) graph.addTask([]{});
+  {
+    ParallelRegion region("test graph");
+    ASSERT_TRUE(graph.run());
+  }
+
+  std::vector<parallelRegionProfile> profile = getParallelProfile();
+  const parallelRegionProfile *tasks = findRegion(profile, "test graph");
+  ASSERT_NE((void*) NULL, tasks);
+  EXPECT_EQ(1u, tasks->launches);
+  EXPECT_EQ(20u, totalItems(*tasks));
+
+  resetParallelProfile();
+  setParallelProfiling(false);
+}
+
+
+TEST(PARALLEL_PROFILE, OFF_RECORDS_NOTHING){
+  setParallelProfiling(false);
+  resetParallelProfile();
+
+  std::vector<f64> values(1000, 1);
+  ParallelRegion region("test off");
+  parallelFor(0, values.size(), 0, [&](csize_t first, csize_t last){
+    for(size_t i = first; i < last; i++) values[i] *= 2;
+  });
+
+  EXPECT_TRUE(getParallelProfile().empty());
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
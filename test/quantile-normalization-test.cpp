@@ -0,0 +1,97 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#include <quantile-normalization.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+//Worked example with a tie in the second column.
+TEST(QUANTILE_NORMALIZATION, SMALL_EXAMPLE){
+  std::vector<std::vector<double> > data = {
+      {5, 4, 3},
+      {2, 1, 4},
+      {3, 4, 6},
+      {4, 2, 8}
+    };
+
+  quantileNormalize(data);
+
+  //Sorted columns are {2,3,4,5}, {1,2,4,4}, {3,4,6,8}, so the reference
+  //is {2, 3, 14/3, 17/3}.  The two 4s in column 1 share ranks 2 and 3.
+  const std::vector<std::vector<double> > expected = {
+      {17.0/3, 31.0/6, 2},
+      {2, 2, 3},
+      {3, 31.0/6, 14.0/3},
+      {14.0/3, 3, 17.0/3}
+    };
+
+  for(size_t y = 0; y < data.size(); y++)
+    for(size_t x = 0; x < data[y].size(); x++)
+      EXPECT_NEAR(data[y][x], expected[y][x], 1e-12);
+}
+
+
+TEST(QUANTILE_NORMALIZATION, COLUMNS_SHARE_DISTRIBUTION){
+  const size_t numRows = 97, numCols = 13;
+  std::vector<std::vector<double> > data(numRows,
+                                          std::vector<double>(numCols));
+  for(size_t y = 0; y < numRows; y++)
+    for(size_t x = 0; x < numCols; x++)
+      data[y][x] = sin((double) y * 1.3 + (double) (x * x)) * (double) (x + 1)
+                                                              + (double) x;
+
+  std::vector<std::vector<double> > original = data;
+  quantileNormalize(data);
+
+  std::vector<double> first(numRows);
+  for(size_t y = 0; y < numRows; y++) first[y] = data[y][0];
+  std::sort(first.begin(), first.end());
+
+  for(size_t x = 0; x < numCols; x++){
+    std::vector<double> column(numRows);
+    for(size_t y = 0; y < numRows; y++) column[y] = data[y][x];
+    std::sort(column.begin(), column.end());
+    for(size_t y = 0; y < numRows; y++)
+      EXPECT_NEAR(column[y], first[y], 1e-12);
+
+    //Order within each column is preserved.
+    for(size_t y = 1; y < numRows; y++){
+      EXPECT_EQ(original[y][x] < original[y-1][x],
+                                            data[y][x] < data[y-1][x]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,117 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <quantized-upper-diagonal-square-matrix.hpp>
+
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Q, typename Layout> static void checkRoundTrip(){
+  const size_t n = 45;
+  UpperDiagonalSquareMatrix<f64, Layout> source(n);
+  QuantizedUpperDiagonalSquareMatrix<Q, Layout> single(n);
+  QuantizedUpperDiagonalSquareMatrix<Q, Layout> bulk(n);
+
+  for(size_t y = 0; y < n; y++){
+    for(size_t x = y; x < n; x++){
+      source.setValueAtIndex(x, y, triangleTestValue(x, y));
+      single.setValueAtIndex(x, y, triangleTestValue(x, y));
+    }
+  }
+  bulk.quantize(source);
+
+  std::vector<f64> row(n);
+  for(size_t y = 0; y < n; y++){
+    bulk.getRow(y, row.data());
+    for(size_t x = 0; x < n; x++){
+      cf64 expected = x >= y ? triangleTestValue(x, y)
+                             : triangleTestValue(y, x);
+      EXPECT_LE(fabs(single.getValueAtIndex(x, y) - expected),
+                                  correlationCodec<Q>::MAX_ERROR);
+      EXPECT_EQ(row[x], single.getValueAtIndex(x, y));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(QUANTIZED_UPPER_DIAGONAL_SQUARE_MATRIX, CODEC_BOUNDS){
+  typedef correlationCodec<s16> codec16;
+  typedef correlationCodec<s8> codec8;
+
+  EXPECT_EQ(codec16::encode(1.0), 32767);
+  EXPECT_EQ(codec16::encode(-1.0), -32767);
+  EXPECT_EQ(codec16::encode(0.0), 0);
+  EXPECT_EQ(codec16::encode(7.5), 32767);
+  EXPECT_EQ(codec16::encode(-INFINITY), -32767);
+  EXPECT_EQ(codec8::encode(NAN), codec8::NAN_CODE);
+  EXPECT_TRUE(isnan(codec8::decode(codec8::encode(NAN))));
+  EXPECT_EQ(codec8::decode(codec8::encode(-1.0)), -1.0);
+
+  //Sweep, including the half way points between codes.
+  for(f64 v = -1; v <= 1; v += 1.0 / 4096){
+    EXPECT_LE(fabs(codec8::decode(codec8::encode(v)) - v),
+                                                  codec8::MAX_ERROR);
+    EXPECT_LE(fabs(codec16::decode(codec16::encode(v)) - v),
+                                                  codec16::MAX_ERROR);
+  }
+}
+
+
+TEST(QUANTIZED_UPPER_DIAGONAL_SQUARE_MATRIX, ROUND_TRIP){
+  checkRoundTrip<s8, RowPackedLayout>();
+  checkRoundTrip<s16, RowPackedLayout>();
+  checkRoundTrip<s16, TiledLayout<8> >();
+}
+
+
+TEST(QUANTIZED_UPPER_DIAGONAL_SQUARE_MATRIX, ROW_SPANS){
+  const size_t n = 20;
+  QuantizedUpperDiagonalSquareMatrix<s16> matrix(n);
+  std::vector<f64> values(n);
+
+  for(size_t y = 0; y < n; y++){
+    for(size_t x = y; x < n; x++) values[x - y] = triangleTestValue(x, y);
+    matrix.setRowSpan(y, values.data());
+  }
+
+  for(size_t y = 0; y < n; y++)
+    for(size_t x = y; x < n; x++)
+      EXPECT_NEAR(matrix.getValueAtIndex(x, y), triangleTestValue(x, y),
+                                correlationCodec<s16>::MAX_ERROR);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,108 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <row-statistics.hpp>
+#include <statistics.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(ROW_STATISTICS, MATCHES_TWO_PASS){
+  std::vector<std::vector<double> > data(50, std::vector<double>(23));
+  for(size_t y = 0; y < data.size(); y++)
+    for(size_t x = 0; x < data[y].size(); x++)
+      data[y][x] = 1e6 + sin((f64) y * 7.0 + (f64) (x * x) * 0.3)
+                                                      * (f64) (y + 1);
+
+  rowStatistics stats = calculateRowStatistics(data);
+  ASSERT_EQ(stats.mean.size(), data.size());
+
+  for(size_t y = 0; y < data.size(); y++){
+    csize_t n = data[y].size();
+    cf64 mean = getMean(data[y].data(), n);
+    f64 m2 = 0, m3 = 0, m4 = 0, low = data[y][0], high = data[y][0];
+    for(size_t x = 0; x < n; x++){
+      cf64 d = data[y][x] - mean;
+      m2 += d * d;
+      m3 += d * d * d;
+      m4 += d * d * d * d;
+      low = fmin(low, data[y][x]);
+      high = fmax(high, data[y][x]);
+    }
+
+    EXPECT_EQ(stats.count[y], n);
+    EXPECT_EQ(stats.nanCount[y], 0u);
+    EXPECT_NEAR(stats.mean[y], mean, 1e-8);
+    EXPECT_NEAR(sqrt(stats.variance[y]),
+                          getStandardDeviation(data[y].data(), n), 1e-8);
+    EXPECT_NEAR(stats.skewness[y], sqrt((f64) n) * m3 / pow(m2, 1.5), 1e-6);
+    EXPECT_NEAR(stats.kurtosis[y], (f64) n * m4 / (m2 * m2) - 3, 1e-6);
+    EXPECT_EQ(stats.minimum[y], low);
+    EXPECT_EQ(stats.maximum[y], high);
+  }
+}
+
+
+TEST(ROW_STATISTICS, NAN_AND_DEGENERATE_ROWS){
+  cf64 nan = NAN;
+  std::vector<std::vector<double> > data = {
+      {1, nan, 2, 3, nan},
+      {nan, nan},
+      {4},
+      {5, 5, 5}
+    };
+
+  rowStatistics stats = calculateRowStatistics(data);
+
+  EXPECT_EQ(stats.count[0], 3u);
+  EXPECT_EQ(stats.nanCount[0], 2u);
+  EXPECT_DOUBLE_EQ(stats.mean[0], 2);
+  EXPECT_DOUBLE_EQ(stats.variance[0], 1);
+  EXPECT_NEAR(stats.skewness[0], 0, 1e-12);
+  EXPECT_DOUBLE_EQ(stats.kurtosis[0], -1.5);
+  EXPECT_EQ(stats.minimum[0], 1);
+  EXPECT_EQ(stats.maximum[0], 3);
+
+  EXPECT_EQ(stats.count[1], 0u);
+  EXPECT_TRUE(isnan(stats.mean[1]));
+  EXPECT_TRUE(isnan(stats.minimum[1]));
+
+  EXPECT_DOUBLE_EQ(stats.mean[2], 4);
+  EXPECT_TRUE(isnan(stats.variance[2]));
+
+  EXPECT_DOUBLE_EQ(stats.variance[3], 0);
+  EXPECT_TRUE(isnan(stats.skewness[3]));
+  EXPECT_TRUE(isnan(stats.kurtosis[3]));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
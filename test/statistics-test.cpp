@@ -24,7 +24,11 @@
 ////////////////////////////////////////////////////////////////////////
 
 
-#include <statistics.h>
+#include <math.h>
+#include <vector>
+
+#include <fixed-length-statistics.hpp>
+#include <statistics.hpp>
 
 #include "gtest/gtest.h"
 
@@ -71,6 +75,97 @@ f64 getCenteredCorrelationBasic(cf64 aSumOfSquares, cf64 bSumOfSquares,
 void inplaceCenterMean(f64 *array, csize_t size);
 */
 
+
+TEST(STATISTICS, FIXED_LENGTH_KERNELS){
+  for(size_t size = 1; size <= MAX_FIXED_KERNEL_LENGTH + 8; size++){
+    std::vector<f64> left(size), right(size);
+    for(size_t i = 0; i < size; i++){
+      left[i] = 0.5 * (f64) i - 3.0;
+      right[i] = 1.0 / ((f64) i + 1.0);
+    }
+
+    cf64 expected = getSumOfMultipliedArrays(left.data(), right.data(),
+                                                                  size);
+    sumOfMultipliedArraysFunction kernel =
+                                      selectSumOfMultipliedArrays(size);
+    EXPECT_NEAR(kernel(left.data(), right.data(), size), expected, 1e-12);
+  }
+}
+
+
+TEST(STATISTICS, PINNED_FIXED_LENGTH_KERNELS){
+  const size_t numRows = 7;
+  for(size_t size = 1; size <= MAX_FIXED_KERNEL_LENGTH + 8; size++){
+    std::vector<std::vector<f64> > rows(numRows, std::vector<f64>(size));
+    std::vector<cf64*> rowPointers(numRows);
+    std::vector<f64> pinned(size), results(numRows);
+    for(size_t i = 0; i < size; i++){
+      pinned[i] = 1.0 - 0.25 * (f64) i;
+      for(size_t r = 0; r < numRows; r++) rows[r][i] = (f64) (r * i % 5);
+    }
+    for(size_t r = 0; r < numRows; r++) rowPointers[r] = rows[r].data();
+
+    pinnedSumsOfMultipliedArraysFunction kernel =
+                                selectPinnedSumsOfMultipliedArrays(size);
+    kernel(pinned.data(), rowPointers.data(), numRows, size,
+                                                        results.data());
+    for(size_t r = 0; r < numRows; r++){
+      EXPECT_NEAR(results[r], getSumOfMultipliedArrays(pinned.data(),
+                                      rows[r].data(), size), 1e-12);
+    }
+  }
+}
+
+
+TEST(STATISTICS, INSTRUCTION_SET_KERNELS_AGREE){
+  const simdInstructionSet original = getStatisticsInstructionSet();
+
+  for(size_t size = 0; size <= 100; size++){
+    std::vector<f64> left(size), right(size);
+    for(size_t i = 0; i < size; i++){
+      left[i] = 0.5 * (f64) i - 3.0;
+      right[i] = 1.0 / ((f64) i + 1.0);
+    }
+
+    ASSERT_TRUE(setStatisticsInstructionSet(SIMD_SCALAR));
+    cf64 sum = getSum(left.data(), size);
+    cf64 squares = getSumOfSquares(left.data(), size);
+    cf64 cross = getSumOfMultipliedArrays(left.data(), right.data(), size);
+
+    for(int level = SIMD_SSE2; level <= SIMD_AVX512; level++){
+      if(!setStatisticsInstructionSet((simdInstructionSet) level)) break;
+      EXPECT_NEAR(getSum(left.data(), size), sum, 1e-10);
+      EXPECT_NEAR(getSumOfSquares(left.data(), size), squares, 1e-9);
+      EXPECT_NEAR(getSumOfMultipliedArrays(left.data(), right.data(),
+                                                  size), cross, 1e-10);
+    }
+  }
+
+  EXPECT_TRUE(setStatisticsInstructionSet(original));
+}
+
+
+TEST(STATISTICS, DISTRIBUTION_P_VALUES){
+  //Closed forms: t with 1 and 2 degrees of freedom, and F with 2
+  //numerator degrees of freedom.
+  for(f64 t = 0; t < 40; t += 0.37){
+    EXPECT_NEAR(getStudentTPValue(t, 1), 1 - 2 / M_PI * atan(t), 1e-13);
+    EXPECT_NEAR(getStudentTPValue(-t, 2), 1 - t / sqrt(2 + t * t), 1e-13);
+    EXPECT_NEAR(getFPValue(t, 2, 9), pow(1 + 2 * t / 9, -4.5), 1e-13);
+  }
+
+  //Textbook critical values at the 5% level.
+  EXPECT_NEAR(getStudentTPValue(2.228139, 10), 0.05, 1e-6);
+  EXPECT_NEAR(getStudentTPValue(1.959964, 1e7), 0.05, 1e-6);
+  EXPECT_NEAR(getFPValue(3.098391, 3, 20), 0.05, 1e-6);
+
+  EXPECT_EQ(regularizedIncompleteBeta(2, 3, 0), 0);
+  EXPECT_EQ(regularizedIncompleteBeta(2, 3, 1), 1);
+  //I_x(1, b) = 1 - (1-x)^b
+  EXPECT_NEAR(regularizedIncompleteBeta(1, 3.5, 0.3),
+                                          1 - pow(0.7, 3.5), 1e-14);
+}
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,109 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <symmetric-matrix-products.hpp>
+
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Layout> static void checkProducts(csize_t n){
+  UpperDiagonalSquareMatrix<f64, Layout> matrix(n);
+  for(size_t y = 0; y < n; y++)
+    for(size_t x = y; x < n; x++)
+      matrix.setValueAtIndex(x, y, unitDiagonalTestValue(x, y));
+
+  const size_t k = 3;
+  std::vector<f64> in(n * k), out(n * k), single(n), singleOut(n);
+  for(size_t i = 0; i < n * k; i++) in[i] = cos(0.1 * (f64) i);
+  for(size_t i = 0; i < n; i++) single[i] = in[i * k + 1];
+
+  multiplySymmetricMatrixBlock(matrix, in.data(), k, out.data());
+  multiplySymmetricMatrixVector(matrix, single.data(), singleOut.data());
+
+  for(size_t i = 0; i < n; i++){
+    for(size_t v = 0; v < k; v++){
+      f64 expected = 0;
+      for(size_t j = 0; j < n; j++)
+        expected += matrix.getValueAtIndex(i, j) * in[j * k + v];
+      EXPECT_NEAR(out[i * k + v], expected, 1e-10);
+      if(1 == v){
+        EXPECT_NEAR(singleOut[i], expected, 1e-10);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(SYMMETRIC_MATRIX_PRODUCTS, ROW_PACKED){
+  checkProducts<RowPackedLayout>(211);
+  checkProducts<RowPackedLayout>(1);
+  checkProducts<RowPackedLayout>(0);
+}
+
+
+TEST(SYMMETRIC_MATRIX_PRODUCTS, TILED){
+  checkProducts<TiledLayout<16> >(150);
+}
+
+
+//A few power iterations land on the top eigenvector of a matrix with
+//a known spectrum: all ones off the diagonal, so J - I + d I.
+TEST(SYMMETRIC_MATRIX_PRODUCTS, POWER_ITERATION){
+  const size_t n = 100;
+  UpperDiagonalSquareMatrix<f32> matrix(n);
+  matrix.fill(1);
+
+  std::vector<f64> v(n), next(n);
+  for(size_t i = 0; i < n; i++) v[i] = 1 + 0.01 * (f64) (i % 7);
+  f64 eigenvalue = 0;
+  for(size_t iteration = 0; iteration < 20; iteration++){
+    multiplySymmetricMatrixVector(matrix, v.data(), next.data());
+    f64 norm = 0, dot = 0;
+    for(size_t i = 0; i < n; i++){
+      norm += next[i] * next[i];
+      dot += next[i] * v[i];
+    }
+    f64 vNorm = 0;
+    for(size_t i = 0; i < n; i++) vNorm += v[i] * v[i];
+    eigenvalue = dot / vNorm;
+    for(size_t i = 0; i < n; i++) v[i] = next[i] / sqrt(norm);
+  }
+
+  EXPECT_NEAR(eigenvalue, (f64) n, 1e-9);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <vector>
+
+#include <simple-thread-dispatch.hpp>
+#include <task-graph.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(TASK_GRAPH, DEPENDENCIES_ARE_RESPECTED){
+  //Task i depends on tasks i/2 and i/3 (when smaller), a wide and deep
+  //enough graph to interleave on several workers.
+  csize_t numTasks = 2000;
+  std::vector<std::atomic<size_t> > finished(numTasks);
+  std::atomic<size_t> violations(0);
+  std::atomic<size_t> clock(1);
+  TaskGraph graph;
+
+  for(size_t i = 0; i < numTasks; i++){
+    graph.addTask([&, i]{
+      if(i > 0 && (0 == finished[i/2] || 0 == finished[i/3]))
+        violations++;
+      finished[i] = clock++;
+    });
+  }
+  for(size_t i = 1; i < numTasks; i++){
+    graph.addDependency(i/2, i);
+    if(i/3 != i/2) graph.addDependency(i/3, i);
+  }
+  EXPECT_EQ(numTasks, graph.numberOfTasks());
+
+  for(int run = 0; run < 3; run++){
+    for(size_t i = 0; i < numTasks; i++) finished[i] = 0;
+    ASSERT_TRUE(graph.run());
+    EXPECT_EQ(0u, violations.load());
+    for(size_t i = 0; i < numTasks; i++) ASSERT_NE(0u, finished[i].load());
+  }
+}
+
+
+TEST(TASK_GRAPH, CYCLES_RUN_NOTHING){
+  std::atomic<size_t> ran(0);
+  TaskGraph graph;
+  size_t a = graph.addTask([&ran]{ ran++; });
+  size_t b = graph.addTask([&ran]{ ran++; });
+  size_t c = graph.addTask([&ran]{ ran++; });
+  graph.addDependency(a, b);
+  graph.addDependency(b, c);
+  graph.addDependency(c, b);
+
+  EXPECT_FALSE(graph.run());
+  EXPECT_EQ(0u, ran.load());
+
+  TaskGraph empty;
+  EXPECT_TRUE(empty.run());
+}
+
+
+TEST(TASK_GRAPH, TASKS_MAY_LAUNCH_PARALLEL_WORK){
+  setThreadCount(4);
+
+  std::atomic<size_t> shares(0);
+  TaskGraph graph;
+  size_t first = graph.addTask([]{});
+  for(size_t i = 0; i < 8; i++){
+    size_t task = graph.addTask([&shares]{
+      autoThreadLauncher([](void *protoArgs) -> void*{
+        struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+        (*(std::atomic<size_t>*) arg->specifics)++;
+        return NULL;
+      }, (void*) &shares);
+    });
+    graph.addDependency(first, task);
+  }
+
+  EXPECT_TRUE(graph.run());
+  EXPECT_EQ(8u * 4u, shares.load());
+
+  setThreadCount(0);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
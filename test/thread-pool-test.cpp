@@ -0,0 +1,224 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <sched.h>
+#include <string>
+#include <vector>
+
+#include <simple-thread-dispatch.hpp>
+#include <thread-pool.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+struct countingStruct{
+  std::vector<std::atomic<size_t> > *seen;
+  std::atomic<size_t> *total;
+};
+
+
+static void *countingHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  countingStruct *args = (countingStruct*) arg->specifics;
+  (*args->seen)[arg->numerator]++;
+  (*args->total) += arg->denominator;
+  return NULL;
+}
+
+
+static void *nestedHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  std::atomic<size_t> *total = (std::atomic<size_t>*) arg->specifics;
+
+  std::vector<std::atomic<size_t> > seen(autoThreadCount());
+  std::atomic<size_t> innerTotal(0);
+  countingStruct inner = {&seen, &innerTotal};
+  autoThreadLauncher(countingHelper, (void*) &inner);
+
+  (*total) += seen.size() == innerTotal / autoThreadCount();
+  return NULL;
+}
+
+
+struct nestedRunStruct{
+  ThreadPool *pool;
+  std::atomic<size_t> *total;
+};
+
+
+static void *incrementHelper(void *protoArg);
+
+
+//Each share runs eight more on the same pool from inside a job.
+static void *nestedRunHelper(void *protoArgs){
+  struct multithreadLoad *arg = (struct multithreadLoad*) protoArgs;
+  nestedRunStruct *args = (nestedRunStruct*) arg->specifics;
+
+  std::vector<struct multithreadLoad> loads(8);
+  for(size_t i = 0; i < loads.size(); i++)
+    loads[i] = {i, loads.size(), (void*) args->total};
+  args->pool->run([](void *load) -> void*{
+    return incrementHelper(((struct multithreadLoad*) load)->specifics);
+  }, loads.data(), loads.size());
+
+  return NULL;
+}
+
+
+static void *incrementHelper(void *protoArg){
+  (*(std::atomic<size_t>*) protoArg)++;
+  return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(THREAD_POOL, EVERY_SHARE_RUNS_ONCE){
+  csize_t numCPUs = autoThreadCount();
+
+  for(size_t call = 0; call < 200; call++){
+    std::vector<std::atomic<size_t> > seen(numCPUs);
+    std::atomic<size_t> total(0);
+    countingStruct instructions = {&seen, &total};
+
+    autoThreadLauncher(countingHelper, (void*) &instructions);
+
+    for(size_t i = 0; i < numCPUs; i++) ASSERT_EQ(1u, seen[i].load());
+    ASSERT_EQ(numCPUs * numCPUs, total.load());
+  }
+}
+
+
+TEST(THREAD_POOL, NESTED_LAUNCH_COMPLETES){
+  std::atomic<size_t> completed(0);
+  autoThreadLauncher(nestedHelper, (void*) &completed);
+  EXPECT_EQ(autoThreadCount(), completed.load());
+}
+
+
+TEST(THREAD_POOL, GROUPS_AND_PRIVATE_POOLS){
+  for(size_t numWorkers = 0; numWorkers < 4; numWorkers++){
+    ThreadPool pool(numWorkers);
+    EXPECT_EQ(numWorkers, pool.numberOfWorkers());
+
+    std::atomic<size_t> count(0);
+    threadPoolGroup group;
+    for(size_t i = 0; i < 1000; i++)
+      pool.submit(incrementHelper, (void*) &count, &group);
+    pool.wait(&group);
+    EXPECT_EQ(1000u, count.load());
+
+    count = 0;
+    nestedRunStruct shared = {&pool, &count};
+    std::vector<struct multithreadLoad> loads(16);
+    for(size_t i = 0; i < loads.size(); i++)
+      loads[i] = {i, loads.size(), (void*) &shared};
+    pool.run(nestedRunHelper, loads.data(), loads.size());
+    EXPECT_EQ(16u * 8u, count.load());
+  }
+}
+
+
+TEST(THREAD_POOL, WAIT_RUNS_ONLY_ITS_GROUP){
+  //With no workers, only a waiter can run a job.
+  ThreadPool pool(0);
+  std::atomic<size_t> mine(0), theirs(0);
+  threadPoolGroup myGroup, theirGroup;
+
+  pool.submit(incrementHelper, (void*) &theirs, &theirGroup);
+  pool.submit(incrementHelper, (void*) &mine, &myGroup);
+  pool.wait(&myGroup);
+  EXPECT_EQ(1u, mine.load());
+  EXPECT_EQ(0u, theirs.load());
+
+  pool.wait(&theirGroup);
+  EXPECT_EQ(1u, theirs.load());
+}
+
+
+TEST(THREAD_POOL, PARSE_CPU_LIST){
+  std::vector<size_t> cpus;
+  ASSERT_TRUE(parseCPUList("0-3,8,10-11\n", cpus));
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2, 3, 8, 10, 11}), cpus);
+  ASSERT_TRUE(parseCPUList("5,2,2", cpus));
+  EXPECT_EQ(std::vector<size_t>({2, 5}), cpus);
+  ASSERT_TRUE(parseCPUList("", cpus));
+  EXPECT_TRUE(cpus.empty());
+  EXPECT_FALSE(parseCPUList("3-1", cpus));
+  EXPECT_FALSE(parseCPUList("a", cpus));
+  EXPECT_FALSE(parseCPUList("1;2", cpus));
+  //Beyond what a cpu_set_t can hold, and so never expanded.
+  EXPECT_FALSE(parseCPUList("0-99999999999", cpus));
+  EXPECT_FALSE(parseCPUList(std::to_string(CPU_SETSIZE), cpus));
+  ASSERT_TRUE(parseCPUList(std::to_string(CPU_SETSIZE - 1), cpus));
+  EXPECT_EQ(std::vector<size_t>({CPU_SETSIZE - 1}), cpus);
+}
+
+
+TEST(THREAD_POOL, POLICY){
+  setThreadCount(5);
+  EXPECT_EQ(5u, autoThreadCount());
+  EXPECT_EQ(4u, getThreadPool().numberOfWorkers());
+
+  std::vector<std::atomic<size_t> > seen(5);
+  std::atomic<size_t> total(0);
+  countingStruct instructions = {&seen, &total};
+  autoThreadLauncher(countingHelper, (void*) &instructions);
+  for(size_t i = 0; i < seen.size(); i++) EXPECT_EQ(1u, seen[i].load());
+
+  std::atomic<size_t> completed(0);
+  autoThreadLauncher(nestedHelper, (void*) &completed);
+  EXPECT_EQ(5u, completed.load());
+
+  setThreadCount(0);
+  std::vector<size_t> all = getThreadCPUs();
+  ASSERT_FALSE(all.empty());
+  EXPECT_FALSE(threadsArePinned());
+  EXPECT_LE(autoThreadCount(), all.size());
+
+  setUseSMTSiblings(false);
+  std::vector<size_t> cores = getThreadCPUs();
+  EXPECT_FALSE(cores.empty());
+  EXPECT_LE(cores.size(), all.size());
+  setUseSMTSiblings(true);
+
+  ASSERT_TRUE(setThreadCPUList(std::to_string(all[0])));
+  EXPECT_TRUE(threadsArePinned());
+  EXPECT_EQ(std::vector<size_t>(1, all[0]), getThreadCPUs());
+  EXPECT_EQ(1u, autoThreadCount());
+  EXPECT_FALSE(setThreadCPUList("x"));
+  ASSERT_TRUE(setThreadCPUList(""));
+  EXPECT_FALSE(threadsArePinned());
+  EXPECT_EQ(all, getThreadCPUs());
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
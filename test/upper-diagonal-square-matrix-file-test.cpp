@@ -0,0 +1,154 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <upper-diagonal-square-matrix-file.hpp>
+
+#include "gtest/gtest.h"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+static std::string testPath(){
+  return std::string(P_tmpdir) + "/madlib-matrix-file-test.udsm";
+}
+
+
+template<typename T, typename Layout> static void fillMatrix(
+                            UpperDiagonalSquareMatrix<T, Layout> &m){
+  for(size_t y = 0; y < m.getSideLength(); y++)
+    for(size_t x = y; x < m.getSideLength(); x++)
+      m.setValueAtIndex(x, y, (T) (y * 1000 + x));
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(UPPER_DIAGONAL_SQUARE_MATRIX_FILE, SAVE_LOAD_AND_MAP){
+  const std::string path = testPath();
+  const size_t n = 300;
+  UpperDiagonalSquareMatrix<f64> source(n);
+  fillMatrix(source);
+  ASSERT_TRUE(saveUpperDiagonalSquareMatrix(path, source));
+
+  matrixFileDescription found;
+  ASSERT_TRUE(readMatrixFileDescription(path, found));
+  EXPECT_EQ(found.elementType, (u32) MATRIX_ELEMENT_F64);
+  EXPECT_EQ(found.sideLength, n);
+  EXPECT_EQ(found.layout, (u32) MATRIX_LAYOUT_ROW_PACKED);
+
+  UpperDiagonalSquareMatrix<f64> *loaded =
+                        loadUpperDiagonalSquareMatrix<f64>(path);
+  ASSERT_NE(loaded, nullptr);
+
+  MappedUpperDiagonalSquareMatrix<f64> mapped;
+  ASSERT_TRUE(mapped.open(path, true));
+
+  for(size_t y = 0; y < n; y++){
+    for(size_t x = 0; x < n; x++){
+      EXPECT_EQ(loaded->getValueAtIndex(x, y), source.getValueAtIndex(x, y));
+      EXPECT_EQ(mapped.getMatrix().getValueAtIndex(x, y),
+                                          source.getValueAtIndex(x, y));
+    }
+  }
+
+  delete loaded;
+  mapped.close();
+  unlink(path.c_str());
+}
+
+
+TEST(UPPER_DIAGONAL_SQUARE_MATRIX_FILE, TYPE_AND_LAYOUT_CHECKED){
+  const std::string path = testPath();
+  UpperDiagonalSquareMatrix<s16, TiledLayout<16> > source(70);
+  fillMatrix(source);
+  ASSERT_TRUE(saveUpperDiagonalSquareMatrix(path, source));
+
+  EXPECT_EQ(loadUpperDiagonalSquareMatrix<f64>(path), nullptr);
+  EXPECT_EQ(loadUpperDiagonalSquareMatrix<s16>(path), nullptr);
+  EXPECT_EQ((loadUpperDiagonalSquareMatrix<s16, TiledLayout<8> >(path)),
+                                                                nullptr);
+
+  MappedUpperDiagonalSquareMatrix<s16, TiledLayout<16> > mapped;
+  ASSERT_TRUE(mapped.open(path));
+  for(size_t y = 0; y < 70; y++)
+    for(size_t x = y; x < 70; x++)
+      EXPECT_EQ(mapped.getMatrix().getValueAtIndex(x, y),
+                                          source.getValueAtIndex(x, y));
+  mapped.close();
+  unlink(path.c_str());
+}
+
+
+TEST(UPPER_DIAGONAL_SQUARE_MATRIX_FILE, DAMAGE_DETECTED){
+  const std::string path = testPath();
+  UpperDiagonalSquareMatrix<f64> source(50);
+  fillMatrix(source);
+  ASSERT_TRUE(saveUpperDiagonalSquareMatrix(path, source));
+
+  //Flip one byte of data.
+  int fd = open(path.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  u8 byte;
+  ASSERT_EQ(pread(fd, &byte, 1, matrixFileDataOffset() + 777), 1);
+  byte ^= 0x10;
+  ASSERT_EQ(pwrite(fd, &byte, 1, matrixFileDataOffset() + 777), 1);
+  close(fd);
+
+  EXPECT_EQ(loadUpperDiagonalSquareMatrix<f64>(path), nullptr);
+  MappedUpperDiagonalSquareMatrix<f64> mapped;
+  EXPECT_FALSE(mapped.open(path, true));
+  EXPECT_TRUE(mapped.open(path, false));
+  mapped.close();
+
+  //Truncated.
+  ASSERT_EQ(truncate(path.c_str(), matrixFileDataOffset() + 100), 0);
+  EXPECT_FALSE(mapped.open(path, false));
+  EXPECT_EQ(loadUpperDiagonalSquareMatrix<f64>(path), nullptr);
+
+  //A side length far too large for the data is refused before any
+  //allocation is attempted.
+  std::vector<f64> few(10, 1.0);
+  matrixFileDescription wrong = describeMatrix(source);
+  wrong.sideLength = (u64) 1 << 40;
+  wrong.numElements = few.size();
+  ASSERT_TRUE(writeMatrixFile(path, wrong, few.data()));
+  EXPECT_EQ(loadUpperDiagonalSquareMatrix<f64>(path), nullptr);
+  EXPECT_FALSE(mapped.open(path, false));
+
+  unlink(path.c_str());
+  EXPECT_FALSE(mapped.open(path, false));
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
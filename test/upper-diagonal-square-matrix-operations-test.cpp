@@ -0,0 +1,114 @@
+/*Copyright 2017-2018 Josh Marshall********************************************/
+
+/***********************************************************************
+    This file is part of "Marshall's  Datastructures and Algorithms".
+
+    "Marshall's  Datastructures and Algorithms" is free software: you
+    can redistribute it and/or modify it under the terms of the GNU
+    General Public License as published by the Free Software Foundation,
+    either version 3 of the License, or (at your option) any later
+    version.
+
+    "Marshall's  Datastructures and Algorithms" is distributed in the
+    hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+    the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+    PURPOSE.  See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with "Marshall's  Datastructures and Algorithms".  If not, see
+    <http://www.gnu.org/licenses/>.
+***********************************************************************/
+
+////////////////////////////////////////////////////////////////////////
+//INCLUDES//////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <vector>
+
+#include <upper-diagonal-square-matrix-operations.hpp>
+
+#include "gtest/gtest.h"
+#include "matrix-test-resources.hpp"
+
+////////////////////////////////////////////////////////////////////////
+//TEST RESOURCES////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<typename Layout> static void checkOperations(){
+  const size_t n = 173;
+  UpperDiagonalSquareMatrix<f64, Layout> matrix(n);
+  for(size_t y = 0; y < n; y++)
+    for(size_t x = y; x < n; x++)
+      matrix.setValueAtIndex(x, y, unitDiagonalTestValue(x, y));
+
+  transformUpperDiagonalSquareMatrix(matrix, [](f64 v){ return v * 0.5; });
+
+  f64 sum = 0, offDiagonalSum = 0;
+  size_t strong = 0;
+  std::vector<matrixEntry<f64> > expected;
+  for(size_t y = 0; y < n; y++){
+    for(size_t x = y; x < n; x++){
+      cf64 v = unitDiagonalTestValue(x, y) * 0.5;
+      EXPECT_EQ(matrix.getValueAtIndex(x, y), v);
+      sum += v;
+      if(x == y) continue;
+      offDiagonalSum += v;
+      if(fabs(v) > 0.4){
+        strong++;
+        expected.push_back({x, y, v});
+      }
+    }
+  }
+
+  auto add = [](f64 a, f64 b){ return a + b; };
+  EXPECT_NEAR(reduceUpperDiagonalSquareMatrix(matrix, 0.0, add), sum, 1e-9);
+  EXPECT_NEAR(reduceUpperDiagonalSquareMatrix(matrix, 0.0, add, true),
+                                                    offDiagonalSum, 1e-9);
+
+  auto isStrong = [](f64 v){ return fabs(v) > 0.4; };
+  EXPECT_EQ(countIfUpperDiagonalSquareMatrix(matrix, isStrong, true),
+                                                                strong);
+  EXPECT_EQ(countIfUpperDiagonalSquareMatrix(matrix, isStrong),
+                                                            strong + n);
+
+  std::vector<matrixEntry<f64> > found =
+            extractIfUpperDiagonalSquareMatrix(matrix, isStrong, true);
+  ASSERT_EQ(found.size(), expected.size());
+  for(size_t i = 0; i < found.size(); i++){
+    EXPECT_EQ(found[i].x, expected[i].x);
+    EXPECT_EQ(found[i].y, expected[i].y);
+    EXPECT_EQ(found[i].value, expected[i].value);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+//TESTS/////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+TEST(UPPER_DIAGONAL_SQUARE_MATRIX_OPERATIONS, ROW_PACKED){
+  checkOperations<RowPackedLayout>();
+}
+
+
+TEST(UPPER_DIAGONAL_SQUARE_MATRIX_OPERATIONS, TILED){
+  checkOperations<TiledLayout<16> >();
+}
+
+
+TEST(UPPER_DIAGONAL_SQUARE_MATRIX_OPERATIONS, EMPTY_AND_TINY){
+  UpperDiagonalSquareMatrix<u8> empty(0);
+  EXPECT_EQ(countIfUpperDiagonalSquareMatrix(empty,
+                                    [](u8){ return true; }), 0u);
+
+  UpperDiagonalSquareMatrix<u8> one(1);
+  one.setValueAtIndex(0, 0, 7);
+  EXPECT_EQ(reduceUpperDiagonalSquareMatrix(one, (size_t) 0,
+                  [](size_t a, size_t b){ return a + b; }), 7u);
+  EXPECT_EQ(reduceUpperDiagonalSquareMatrix(one, (size_t) 0,
+                  [](size_t a, size_t b){ return a + b; }, true), 0u);
+}
+
+////////////////////////////////////////////////////////////////////////
+//END///////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
@@ -21,7 +21,9 @@
 //INCLUDES//////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+#include <stdlib.h>
 #include <upper-diagonal-square-matrix.hpp>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -77,6 +79,140 @@ TEST(UpperDiagonalMatrixTest, DataIntegrity){
 
 
 
+TEST(UpperDiagonalMatrixTest, TiledLayoutMatchesRowPacked){
+
+  //Side length deliberately not a multiple of the tile size.
+  const size_t sideLength = 37;
+  UpperDiagonalSquareMatrix<size_t> packed(sideLength);
+  UpperDiagonalSquareMatrix<size_t, TiledLayout<8> > tiled(sideLength);
+  std::vector<bool> used(tiled.numberOfElements(), false);
+
+  for(size_t y = 0; y < sideLength; y++){
+    for(size_t x = y; x < sideLength; x++){
+      packed.setValueAtIndex(x, y, y * sideLength + x);
+      tiled.setValueAtIndex(x, y, y * sideLength + x);
+
+      csize_t w = tiled.XYtoW(x, y);
+      ASSERT_LT(w, used.size());
+      EXPECT_FALSE(used[w]);
+      used[w] = true;
+      EXPECT_EQ(tiled.WtoXY(w).first, x);
+      EXPECT_EQ(tiled.WtoXY(w).second, y);
+    }
+  }
+
+  for(size_t y = 0; y < sideLength; y++)
+    for(size_t x = 0; x < sideLength; x++)
+      EXPECT_EQ(tiled.getValueAtIndex(x, y), packed.getValueAtIndex(x, y));
+
+  //Tiles are contiguous, row major.
+  size_t *tile = tiled.getReferenceForIndex(16, 8);
+  for(size_t r = 0; r < 8; r++)
+    for(size_t c = 0; c < 8; c++)
+      EXPECT_EQ(tile[r * 8 + c], (8 + r) * sideLength + 16 + c);
+}
+
+
+TEST(UpperDiagonalMatrixTest, RowAndColumnIterators){
+
+  const size_t sideLength = 29;
+  UpperDiagonalSquareMatrix<size_t> packed(sideLength);
+  UpperDiagonalSquareMatrix<size_t, TiledLayout<4> > tiled(sideLength);
+  for(size_t y = 0; y < sideLength; y++){
+    for(size_t x = y; x < sideLength; x++){
+      packed.setValueAtIndex(x, y, y * sideLength + x);
+      tiled.setValueAtIndex(x, y, y * sideLength + x);
+    }
+  }
+
+  for(size_t i = 0; i < sideLength; i++){
+    size_t x = i;
+    for(auto it = tiled.rowBegin(i); it != tiled.rowEnd(i); ++it, x++){
+      EXPECT_EQ(it.index(), x);
+      EXPECT_EQ(*it, i * sideLength + x);
+    }
+    EXPECT_EQ(x, sideLength);
+
+    size_t y = 0;
+    for(auto it = packed.columnBegin(i); it != packed.columnEnd(i);
+                                                              ++it, y++){
+      EXPECT_EQ(it.index(), y);
+      EXPECT_EQ(*it, y * sideLength + i);
+    }
+    EXPECT_EQ(y, i + 1);
+
+    std::vector<size_t> packedRow(sideLength), tiledRow(sideLength);
+    packed.getRow(i, packedRow.data());
+    tiled.getRow(i, tiledRow.data());
+    for(size_t j = 0; j < sideLength; j++){
+      EXPECT_EQ(packedRow[j], packed.getValueAtIndex(j, i));
+      EXPECT_EQ(tiledRow[j], packedRow[j]);
+    }
+  }
+}
+
+
+
+template<typename T> class countingAllocator{
+  public:
+  typedef T value_type;
+  size_t *live;
+
+  countingAllocator(size_t *live){ this->live = live; }
+  template<typename U> countingAllocator(const countingAllocator<U> &other){
+    live = other.live;
+  }
+
+  T *allocate(csize_t count){
+    *live += count;
+    return (T*) malloc(count * sizeof(T));
+  }
+
+  void deallocate(T *memory, csize_t count){
+    *live -= count;
+    free(memory);
+  }
+};
+
+
+TEST(UpperDiagonalMatrixTest, MoveTransfersStorage){
+  UpperDiagonalSquareMatrix<f64> first(20);
+  first.setValueAtIndex(7, 3, 0.5);
+  f64 *storage = first.data();
+
+  UpperDiagonalSquareMatrix<f64> second(std::move(first));
+  EXPECT_EQ(second.data(), storage);
+  EXPECT_EQ(second.getSideLength(), 20u);
+  EXPECT_EQ(second.getValueAtIndex(3, 7), 0.5);
+  EXPECT_EQ(first.getSideLength(), 0u);
+  EXPECT_TRUE(NULL == first.data());
+
+  UpperDiagonalSquareMatrix<f64> third(5);
+  third = std::move(second);
+  EXPECT_EQ(third.data(), storage);
+  EXPECT_EQ(third.getSideLength(), 20u);
+  EXPECT_TRUE(NULL == second.data());
+}
+
+
+TEST(UpperDiagonalMatrixTest, CustomAllocator){
+  size_t live = 0;
+  {
+    typedef UpperDiagonalSquareMatrix<f64, RowPackedLayout,
+                                  countingAllocator<f64> > countedMatrix;
+    countedMatrix matrix(10, countingAllocator<f64>(&live));
+    EXPECT_EQ(live, matrix.numberOfElements());
+
+    countedMatrix moved(std::move(matrix));
+    EXPECT_EQ(live, moved.numberOfElements());
+
+    moved = countedMatrix(4, countingAllocator<f64>(&live));
+    EXPECT_EQ(live, moved.numberOfElements());
+  }
+  EXPECT_EQ(live, 0u);
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 //END///////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////